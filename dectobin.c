@@ -23,27 +23,11 @@ void initbinary(unsigned char size) {
     }
 }
 
+// Bit i of dec goes to bin[i]. Only the 7 bits of an ASCII code fit in bin, higher bits are dropped
 void dectobin(unsigned char dec) {
-    int pos = 0;
     initbinary(7);
-    if (dec == 0) {
-        return;
-    }
-    if (dec == 1) {
-        bin[1] = 1;
-        return;
+    for (unsigned char pos = 0; pos < 7 && dec != 0; ++pos) {
+        bin[pos] = dec % 2;
+        dec = dec / 2;
     }
-    unsigned char quotient;
-    unsigned char remainder;
-
-    do {
-        quotient = dec / 2;
-        remainder = dec % 2;
-        bin[pos] = remainder;
-        if (quotient < 2) {
-            bin[pos + 1] = quotient;
-        }
-        dec = quotient;
-        ++pos;
-    } while (quotient >= 2);
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+//***************************************************************************
+//  File........: lcd1100_blit.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Drawing of monochrome bitmaps (icons, sprites) on the Nokia 1100 LCD
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_lib.c
+//
+// Bitmap format, the same column bytes as lcd_Font (bit 0 is the top pixel):
+//  byte 0: width in pixels
+//  byte 1: height in pixels
+//  then (height + 7) / 8 lines of "width" bytes each, the first line holds rows 0..7
+// tools/pbm2c.c converts a PBM image into this format.
+
+#ifndef _LCD1100_BLIT_C_
+#define _LCD1100_BLIT_C_
+
+// Function prototypes
+void lcd_blit(signed int16 x, signed int16 y, rom unsigned char *bitmap, unsigned char pixel_mode);
+void lcd_blit_bank(signed int16 x, unsigned char bank, unsigned char shift, int1 next, rom unsigned char *bitmap, unsigned char line, unsigned char pixel_mode);
+
+//******************************************************************************
+// Draws a bitmap with its upper left corner at any position. The parts out of the screen are not drawn
+//  x, y: coordinates of the upper left corner, may be negative
+//  bitmap: bitmap in program memory
+//	pixel_mode: PIXEL_COPY - the bitmap replaces the screen
+//				PIXEL_ON   - OR, pixels set in the bitmap are turned on
+//				PIXEL_OFF  - pixels set in the bitmap are turned off
+//				PIXEL_INV  - XOR, pixels set in the bitmap are inverted
+//				PIXEL_AND  - only screen pixels also set in the bitmap stay on
+void lcd_blit(signed int16 x, signed int16 y, rom unsigned char *bitmap, unsigned char pixel_mode)
+{
+    unsigned char line, lines;
+    signed int16 top;
+
+    if (x >= lcd_X_RES || x + bitmap[0] <= 0)
+        return; // Out of the screen
+
+    lines = (bitmap[1] + 7) / 8;
+
+    LCD_STAT_BEGIN(LCD_STAT_BLIT);
+    for (line = 0; line < lines; line++)
+    {
+        top = y + line * 8; // Screen row of bit 0 of this line of the bitmap
+        if (top >= lcd_Y_RES)
+            break;
+        if (top <= -8)
+            continue;
+
+        // Each line of 8 rows covers the bank of its top row and, when it is not aligned, the next one
+        if (top >= 0)
+            lcd_blit_bank(x, top / 8, top % 8, 0, bitmap, line, pixel_mode);
+        if (top % 8 != 0 && top / 8 + 1 < lcd_BANKS)
+            lcd_blit_bank(x, (top + 8) / 8, (top + 8) % 8, 1, bitmap, line, pixel_mode);
+    }
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Draws the part of one line of a bitmap that falls in one bank, with a single address setting
+//  x: column of the left edge of the bitmap, may be negative
+//  bank: 0..8
+//  shift: 0..7  row of the bank where bit 0 of the line lands (for the next bank: of the line below)
+//  next: 0 - bank of the top of the line, 1 - following bank, with the rows shifted out of it
+//  bitmap: bitmap in program memory
+//  line: line of the bitmap
+//	pixel_mode: as in lcd_blit()
+void lcd_blit_bank(signed int16 x, unsigned char bank, unsigned char shift, int1 next, rom unsigned char *bitmap, unsigned char line, unsigned char pixel_mode)
+{
+    unsigned char width, col, col2, j, bits, area;
+    unsigned int16 i;
+
+    width = bitmap[0];
+
+    // Rows of the line that exist in the bitmap and on the screen
+    area = 0xFF;
+    if (line == bitmap[1] / 8)
+        area = (1 << (bitmap[1] % 8)) - 1;
+    if (next)
+        area >>= 8 - shift;
+    else
+        area <<= shift;
+    if (bank == lcd_Y_RES / 8)
+        area &= (1 << (lcd_Y_RES % 8)) - 1;
+    if (!area)
+        return;
+
+    // Columns on the screen
+    col = (x < 0) ? -x : 0;
+    col2 = (x + width > lcd_X_RES) ? lcd_X_RES - x : width;
+    if (col >= col2)
+        return;
+
+    i = 2 + (unsigned int16)line * width + col;
+    for (j = col; j < col2; j++, i++)
+    {
+        bits = bitmap[i];
+        if (next)
+            bits >>= 8 - shift;
+        else
+            bits <<= shift;
+
+        lcd_rop_src[x + j] = bits;
+    }
+    lcd_rop(x + col, x + col2 - 1, bank, area, pixel_mode | LCD_ROP_BITS);
+}
+
+#endif /* _LCD1100_BLIT_C_ */
@@ -0,0 +1,156 @@
+//***************************************************************************
+//  File........: lcd1100_console.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Text console of 16 x 8 characters for the Nokia 1100 LCD, with new line, wrap and
+//                scroll up. Only the cells whose character changed are drawn again
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_lib.c
+//
+// The console writes to a grid of characters in RAM and lcd_con_refresh() sends the changed cells,
+// in the same 6 x 8 cells as gotoxy() and lcd_print(). Anything else drawn over the text stays until
+// the character of its cell changes.
+
+#ifndef _LCD1100_CONSOLE_C_
+#define _LCD1100_CONSOLE_C_
+
+#define LCD_CON_COLS 16 // lcd_X_RES / 6
+#define LCD_CON_ROWS 8  // Banks 0..7
+
+// Characters of the screen, changed cells of each line (bit n - column n) and cursor
+static char lcd_con_text[LCD_CON_ROWS][LCD_CON_COLS];
+static unsigned int16 lcd_con_dirty[LCD_CON_ROWS];
+static unsigned char lcd_con_x, lcd_con_y;
+
+// Function prototypes
+void lcd_con_init(void);
+void lcd_con_set(unsigned char x, unsigned char y, char c);
+void lcd_con_newline(void);
+void lcd_con_putc(char c);
+void lcd_con_puts(char *message);
+void lcd_con_gotoxy(unsigned char x, unsigned char y);
+void lcd_con_refresh(void);
+
+//******************************************************************************
+// Clears the console and puts the cursor in the upper left corner. The next lcd_con_refresh()
+// draws every cell
+void lcd_con_init(void)
+{
+    unsigned char y;
+
+    memset(lcd_con_text, ' ', sizeof(lcd_con_text));
+    for (y = 0; y < LCD_CON_ROWS; y++)
+        lcd_con_dirty[y] = 0xFFFF;
+    lcd_con_x = 0;
+    lcd_con_y = 0;
+}
+
+//******************************************************************************
+// Sets the character of a cell, marking it only if it changes
+//  x: 0..15
+//  y: 0..7
+//  c: character code
+void lcd_con_set(unsigned char x, unsigned char y, char c)
+{
+    if (lcd_con_text[y][x] != c)
+    {
+        lcd_con_text[y][x] = c;
+        lcd_con_dirty[y] |= (unsigned int16)1 << x;
+    }
+}
+
+//******************************************************************************
+// Moves the cursor to the start of the next line. Below the last line the text scrolls up one line
+// and the last line is cleared
+void lcd_con_newline(void)
+{
+    unsigned char x, y;
+
+    lcd_con_x = 0;
+    if (++lcd_con_y < LCD_CON_ROWS)
+        return;
+
+    lcd_con_y = LCD_CON_ROWS - 1;
+    for (y = 0; y < LCD_CON_ROWS; y++)
+        for (x = 0; x < LCD_CON_COLS; x++)
+            lcd_con_set(x, y, (y < LCD_CON_ROWS - 1) ? lcd_con_text[y + 1][x] : ' ');
+}
+
+//******************************************************************************
+// Writes a character at the cursor
+//  c: character code. '\n' - new line, '\r' - start of the line. At the end of a line the text goes
+//     on in the next one
+void lcd_con_putc(char c)
+{
+    if (c == '\n')
+    {
+        lcd_con_newline();
+        return;
+    }
+    if (c == '\r')
+    {
+        lcd_con_x = 0;
+        return;
+    }
+
+    if (lcd_con_x >= LCD_CON_COLS)
+        lcd_con_newline(); // Wrap, only when there is something to write in the next line
+
+    lcd_con_set(lcd_con_x++, lcd_con_y, c);
+}
+
+//******************************************************************************
+// Writes a string of characters at the cursor
+//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
+void lcd_con_puts(char *message)
+{
+    while (*message)
+        lcd_con_putc(*message++);
+}
+
+//******************************************************************************
+// Sets the cursor of the console
+//  x: 0..15  column
+//  y: 0..7   line
+void lcd_con_gotoxy(unsigned char x, unsigned char y)
+{
+    lcd_con_x = (x < LCD_CON_COLS) ? x : LCD_CON_COLS - 1;
+    lcd_con_y = (y < LCD_CON_ROWS) ? y : LCD_CON_ROWS - 1;
+}
+
+//******************************************************************************
+// Draws the cells changed since the last refresh. Each run of consecutive changed cells of a line
+// costs one address setting and 6 bytes per character
+void lcd_con_refresh(void)
+{
+    unsigned char x, y;
+    int1 run;
+
+    for (y = 0; y < LCD_CON_ROWS; y++)
+    {
+        if (!lcd_con_dirty[y])
+            continue;
+
+        run = 0;
+        for (x = 0; x < LCD_CON_COLS; x++)
+        {
+            if (lcd_con_dirty[y] & ((unsigned int16)1 << x))
+            {
+                if (!run)
+                    gotoxy(x, y); // Start of a run
+                print_char(lcd_con_text[y][x]);
+                run = 1;
+            }
+            else
+                run = 0;
+        }
+        lcd_con_dirty[y] = 0;
+    }
+}
+
+#endif /* _LCD1100_CONSOLE_C_ */
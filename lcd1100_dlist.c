@@ -0,0 +1,300 @@
+//***************************************************************************
+//  File........: lcd1100_dlist.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Display lists for the Nokia 1100 LCD: drawing calls recorded in a RAM arena, or
+//                stored as constant lists in program memory, and drawn in a single pass
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_lib.c
+//
+// A display list is a sequence of records of one opcode byte and its arguments. Coordinates take one
+// byte each and are signed (-128..127), so shapes may stick out of the screen. The low 3 bits of the
+// opcode hold the pixel mode and bit 3 the fill:
+//  DL_PIXEL(x, y, mode)                  3 bytes
+//  DL_LINE(x1, y1, x2, y2, mode)         5 bytes
+//  DL_RECT(x1, y1, x2, y2, fill, mode)   5 bytes
+//  DL_CIRCLE(x, y, radius, fill, mode)   4 bytes
+//  DL_FILL(pattern)                      2 bytes, like lcd_fill()
+//  DL_TEXT(x, y), 'c', 'h', 'a', 'r', 0  like pix_print(), up to LCD_DL_TEXT_MAX characters, clipped
+//                                        at every side like the shapes
+//  DL_END                                end of a list in program memory
+// The records are drawn in order into the video buffer, in deferred mode, and the screen is then
+// updated by one lcd_flush(). They are not reordered: with PIXEL_INV and PIXEL_OFF the result depends
+// on the order of the calls. PIXEL_PATTERN is not recorded: shapes are drawn solid.
+
+#ifndef _LCD1100_DLIST_C_
+#define _LCD1100_DLIST_C_
+
+#ifndef LCD_DL_SIZE
+#define LCD_DL_SIZE 128 // Bytes of the arena for recorded lists, up to 255
+#endif
+#define LCD_DL_TEXT_MAX 20 // Most characters of a text record
+
+// Opcodes
+#define LCD_DL_END 0x00
+#define LCD_DL_PIXEL 0x10
+#define LCD_DL_LINE 0x20
+#define LCD_DL_RECT 0x30
+#define LCD_DL_CIRCLE 0x40
+#define LCD_DL_FILL 0x50
+#define LCD_DL_TEXT 0x60
+#define LCD_DL_FILLED 0x08 // Fill flag of DL_RECT and DL_CIRCLE
+
+// Records for constant lists
+#define DL_B(v) (unsigned char)(v)
+#define DL_PIXEL(x, y, mode) LCD_DL_PIXEL | (mode), DL_B(x), DL_B(y)
+#define DL_LINE(x1, y1, x2, y2, mode) LCD_DL_LINE | (mode), DL_B(x1), DL_B(y1), DL_B(x2), DL_B(y2)
+#define DL_RECT(x1, y1, x2, y2, fill, mode) LCD_DL_RECT | ((fill) ? LCD_DL_FILLED : 0) | (mode), DL_B(x1), DL_B(y1), DL_B(x2), DL_B(y2)
+#define DL_CIRCLE(x, y, radius, fill, mode) LCD_DL_CIRCLE | ((fill) ? LCD_DL_FILLED : 0) | (mode), DL_B(x), DL_B(y), (radius)
+#define DL_FILL(pattern) LCD_DL_FILL, (pattern)
+#define DL_TEXT(x, y) LCD_DL_TEXT, DL_B(x), DL_B(y)
+#define DL_END LCD_DL_END
+
+// Arena of the recorded list and bytes used. Record of a constant list being drawn
+static unsigned char lcd_dl[LCD_DL_SIZE];
+static unsigned char lcd_dl_len;
+static unsigned char lcd_dl_rec[3 + LCD_DL_TEXT_MAX + 1];
+
+// Function prototypes
+void lcd_dl_clear(void);
+int1 lcd_dl_room(unsigned char size);
+int1 lcd_dl_pixel(signed char x, signed char y, unsigned char pixel_mode);
+int1 lcd_dl_line(signed char x1, signed char y1, signed char x2, signed char y2, unsigned char pixel_mode);
+int1 lcd_dl_rectangle(signed char x1, signed char y1, signed char x2, signed char y2, unsigned char fill, unsigned char pixel_mode);
+int1 lcd_dl_circle(signed char x, signed char y, unsigned char radius, unsigned char fill, unsigned char pixel_mode);
+int1 lcd_dl_fill(unsigned char pattern);
+int1 lcd_dl_print(signed char x, signed char y, char *message);
+unsigned char lcd_dl_size(unsigned char op);
+void lcd_dl_exec(unsigned char *rec);
+void lcd_dl_run(void);
+void lcd_dl_run_rom(rom unsigned char *list);
+
+//******************************************************************************
+// Empties the recorded list
+void lcd_dl_clear(void)
+{
+    lcd_dl_len = 0;
+}
+
+//******************************************************************************
+// Checks that a record fits in the arena
+//  size: bytes of the record
+int1 lcd_dl_room(unsigned char size)
+{
+    return (unsigned int16)lcd_dl_len + size <= LCD_DL_SIZE;
+}
+
+//******************************************************************************
+// Records a point, see lcd_pixel()
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_pixel(signed char x, signed char y, unsigned char pixel_mode)
+{
+    if (!lcd_dl_room(3))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_PIXEL | (pixel_mode & LCD_ROP_MODE);
+    lcd_dl[lcd_dl_len++] = x;
+    lcd_dl[lcd_dl_len++] = y;
+    return 1;
+}
+
+//******************************************************************************
+// Records a line, see lcd_line()
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_line(signed char x1, signed char y1, signed char x2, signed char y2, unsigned char pixel_mode)
+{
+    if (!lcd_dl_room(5))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_LINE | (pixel_mode & LCD_ROP_MODE);
+    lcd_dl[lcd_dl_len++] = x1;
+    lcd_dl[lcd_dl_len++] = y1;
+    lcd_dl[lcd_dl_len++] = x2;
+    lcd_dl[lcd_dl_len++] = y2;
+    return 1;
+}
+
+//******************************************************************************
+// Records a rectangle, see lcd_rectangle()
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_rectangle(signed char x1, signed char y1, signed char x2, signed char y2, unsigned char fill, unsigned char pixel_mode)
+{
+    if (!lcd_dl_room(5))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_RECT | (fill ? LCD_DL_FILLED : 0) | (pixel_mode & LCD_ROP_MODE);
+    lcd_dl[lcd_dl_len++] = x1;
+    lcd_dl[lcd_dl_len++] = y1;
+    lcd_dl[lcd_dl_len++] = x2;
+    lcd_dl[lcd_dl_len++] = y2;
+    return 1;
+}
+
+//******************************************************************************
+// Records a circle, see lcd_circle()
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_circle(signed char x, signed char y, unsigned char radius, unsigned char fill, unsigned char pixel_mode)
+{
+    if (!lcd_dl_room(4))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_CIRCLE | (fill ? LCD_DL_FILLED : 0) | (pixel_mode & LCD_ROP_MODE);
+    lcd_dl[lcd_dl_len++] = x;
+    lcd_dl[lcd_dl_len++] = y;
+    lcd_dl[lcd_dl_len++] = radius;
+    return 1;
+}
+
+//******************************************************************************
+// Records the fill of the whole screen, see lcd_fill()
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_fill(unsigned char pattern)
+{
+    if (!lcd_dl_room(2))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_FILL;
+    lcd_dl[lcd_dl_len++] = pattern;
+    return 1;
+}
+
+//******************************************************************************
+// Records a string of characters, see pix_print(). Only the first LCD_DL_TEXT_MAX characters are kept
+//  returns 0 if the arena is full and nothing was recorded
+int1 lcd_dl_print(signed char x, signed char y, char *message)
+{
+    unsigned char n;
+
+    for (n = 0; n < LCD_DL_TEXT_MAX && message[n]; n++)
+        ;
+    if (!lcd_dl_room(3 + n + 1))
+        return 0;
+
+    lcd_dl[lcd_dl_len++] = LCD_DL_TEXT;
+    lcd_dl[lcd_dl_len++] = x;
+    lcd_dl[lcd_dl_len++] = y;
+    while (n--)
+        lcd_dl[lcd_dl_len++] = *message++;
+    lcd_dl[lcd_dl_len++] = 0x00;
+    return 1;
+}
+
+//******************************************************************************
+// Bytes of a record, without the characters of a text
+//  op: opcode
+unsigned char lcd_dl_size(unsigned char op)
+{
+    switch (op & 0xF0)
+    {
+    case LCD_DL_PIXEL:
+        return 3;
+    case LCD_DL_LINE:
+    case LCD_DL_RECT:
+        return 5;
+    case LCD_DL_CIRCLE:
+        return 4;
+    case LCD_DL_FILL:
+        return 2;
+    case LCD_DL_TEXT:
+        return 3;
+    }
+    return 1;
+}
+
+//******************************************************************************
+// Draws one record
+//  rec: the record in RAM
+void lcd_dl_exec(unsigned char *rec)
+{
+    unsigned char mode = rec[0] & 0x07;
+    int1 fill = (rec[0] & LCD_DL_FILLED) != 0;
+
+    switch (rec[0] & 0xF0)
+    {
+    case LCD_DL_PIXEL:
+        lcd_pixel((signed char)rec[1], (signed char)rec[2], mode);
+        break;
+    case LCD_DL_LINE:
+        lcd_line((signed char)rec[1], (signed char)rec[2], (signed char)rec[3], (signed char)rec[4], mode);
+        break;
+    case LCD_DL_RECT:
+        lcd_rectangle((signed char)rec[1], (signed char)rec[2], (signed char)rec[3], (signed char)rec[4], fill, mode);
+        break;
+    case LCD_DL_CIRCLE:
+        lcd_circle((signed char)rec[1], (signed char)rec[2], rec[3], fill, mode);
+        break;
+    case LCD_DL_FILL:
+        lcd_fill(rec[1]);
+        break;
+    case LCD_DL_TEXT:
+        lcd_text((signed char)rec[1], (signed char)rec[2], (char *)(rec + 3), 6); // pix_print() with signed coordinates
+        break;
+    }
+}
+
+//******************************************************************************
+// Draws the recorded list into the video buffer and sends the changes in a single lcd_flush(). The
+// list is kept, call lcd_dl_clear() to record a new one. In deferred mode the changes wait for the
+// next lcd_flush()
+void lcd_dl_run(void)
+{
+    unsigned char i, op;
+    int1 deferred = lcd_get_deferred();
+
+    lcd_set_deferred(DEFERRED_ON);
+
+    for (i = 0; i < lcd_dl_len;)
+    {
+        op = lcd_dl[i];
+        lcd_dl_exec(lcd_dl + i);
+        i += lcd_dl_size(op);
+        if ((op & 0xF0) == LCD_DL_TEXT)
+        {
+            while (lcd_dl[i])
+                i++;
+            i++; // End of the text
+        }
+    }
+
+    if (!deferred)
+        lcd_set_deferred(DEFERRED_OFF);
+}
+
+//******************************************************************************
+// Draws a constant list from program memory like lcd_dl_run(), one record at a time
+//  list: records ending with DL_END
+void lcd_dl_run_rom(rom unsigned char *list)
+{
+    unsigned char n, size;
+    int1 deferred = lcd_get_deferred();
+
+    lcd_set_deferred(DEFERRED_ON);
+
+    while (*list != LCD_DL_END)
+    {
+        size = lcd_dl_size(*list);
+        for (n = 0; n < size; n++)
+            lcd_dl_rec[n] = *list++;
+
+        if ((lcd_dl_rec[0] & 0xF0) == LCD_DL_TEXT)
+        { // Characters up to the 0x00, the ones past LCD_DL_TEXT_MAX are skipped
+            for (; *list; list++)
+                if (n < 3 + LCD_DL_TEXT_MAX)
+                    lcd_dl_rec[n++] = *list;
+            lcd_dl_rec[n] = 0x00;
+            list++;
+        }
+
+        lcd_dl_exec(lcd_dl_rec);
+    }
+
+    if (!deferred)
+        lcd_set_deferred(DEFERRED_OFF);
+}
+
+#endif /* _LCD1100_DLIST_C_ */
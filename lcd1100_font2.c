@@ -0,0 +1,76 @@
+//***************************************************************************
+//  File........: lcd1100_font2.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Fonts for lcd1100_fonts.c, made from lcd1100_font1.c with tools/fontpack.c
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// ./fontpack lcd_font_prop 0x20 0x7F -p
+// ./fontpack lcd_font_digits - :
+
+// lcd_font_prop: characters 0x20..0x7F of lcd_Font, proportional, made with tools/fontpack.c
+// 540 bytes (416 of glyph data, 426 uncompressed)
+rom unsigned char lcd_font_prop[] = {
+    7, 0x20, 96, 0,
+    0x02, 0x01, 0x03, 0x05, 0x05, 0x05, 0x05, 0x02, 0x03, 0x03, 0x05, 0x05,
+    0x02, 0x85, 0x02, 0x05, 0x05, 0x03, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+    0x05, 0x05, 0x02, 0x02, 0x04, 0x85, 0x04, 0x05, 0x05, 0x05, 0x05, 0x05,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x03, 0x05, 0x05, 0x85, 0x05, 0x05, 0x05,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x03,
+    0x05, 0x03, 0x05, 0x85, 0x03, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+    0x05, 0x03, 0x04, 0x04, 0x03, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x03, 0x01, 0x03, 0x05, 0x05,
+    0x00, 0x00, 0x1C, 0x00, 0x37, 0x00, 0x5D, 0x00, 0x7A, 0x00, 0xA2, 0x00,
+    0xC7, 0x00, 0xEF, 0x00, 0x10, 0x01, 0x36, 0x01, 0x58, 0x01, 0x80, 0x01,
+    0x00, 0x00, 0x5F, 0x07, 0x00, 0x07, 0x14, 0x7F, 0x14, 0x7F, 0x14, 0x24,
+    0x2A, 0x7F, 0x2A, 0x12, 0x23, 0x13, 0x08, 0x64, 0x62, 0x36, 0x49, 0x55,
+    0x22, 0x50, 0x05, 0x03, 0x1C, 0x22, 0x41, 0x41, 0x22, 0x1C, 0x08, 0x2A,
+    0x1C, 0x2A, 0x08, 0x08, 0x08, 0x3E, 0x08, 0x08, 0x50, 0x30, 0xFC, 0x08,
+    0x30, 0x30, 0x20, 0x10, 0x08, 0x04, 0x02, 0x3E, 0x51, 0x49, 0x45, 0x3E,
+    0x42, 0x7F, 0x40, 0x42, 0x61, 0x51, 0x49, 0x46, 0x21, 0x41, 0x45, 0x4B,
+    0x31, 0x18, 0x14, 0x12, 0x7F, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39, 0x3C,
+    0x4A, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09, 0x05, 0x03, 0x36, 0x49, 0x49,
+    0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1E, 0x36, 0x36, 0x56, 0x36, 0x08,
+    0x14, 0x22, 0x41, 0xFC, 0x14, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01, 0x51,
+    0x09, 0x06, 0x32, 0x49, 0x79, 0x41, 0x3E, 0x7E, 0x11, 0x11, 0x11, 0x7E,
+    0x7F, 0x49, 0x49, 0x49, 0x36, 0x3E, 0x41, 0x41, 0x41, 0x22, 0x7F, 0x41,
+    0x41, 0x22, 0x1C, 0x7F, 0x49, 0x49, 0x49, 0x41, 0x7F, 0x09, 0x09, 0x01,
+    0x01, 0x3E, 0x41, 0x41, 0x51, 0x32, 0x7F, 0x08, 0x08, 0x08, 0x7F, 0x41,
+    0x7F, 0x41, 0x20, 0x40, 0x41, 0x3F, 0x01, 0x7F, 0x08, 0x14, 0x22, 0x41,
+    0x00, 0x7F, 0xFD, 0x40, 0x7F, 0x02, 0x04, 0x02, 0x7F, 0x7F, 0x04, 0x08,
+    0x10, 0x7F, 0x3E, 0x41, 0x41, 0x41, 0x3E, 0x7F, 0x09, 0x09, 0x09, 0x06,
+    0x3E, 0x41, 0x51, 0x21, 0x5E, 0x7F, 0x09, 0x19, 0x29, 0x46, 0x46, 0x49,
+    0x49, 0x49, 0x31, 0x01, 0x01, 0x7F, 0x01, 0x01, 0x3F, 0x40, 0x40, 0x40,
+    0x3F, 0x1F, 0x20, 0x40, 0x20, 0x1F, 0x7F, 0x20, 0x18, 0x20, 0x7F, 0x63,
+    0x14, 0x08, 0x14, 0x63, 0x03, 0x04, 0x78, 0x04, 0x03, 0x61, 0x51, 0x49,
+    0x45, 0x43, 0x7F, 0x41, 0x41, 0x02, 0x04, 0x08, 0x10, 0x20, 0x41, 0x41,
+    0x7F, 0x04, 0x02, 0x01, 0x02, 0x04, 0xFC, 0x40, 0x01, 0x02, 0x04, 0x20,
+    0x54, 0x54, 0x54, 0x78, 0x7F, 0x48, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44,
+    0x44, 0x20, 0x38, 0x44, 0x44, 0x48, 0x7F, 0x38, 0x54, 0x54, 0x54, 0x18,
+    0x08, 0x7E, 0x09, 0x01, 0x02, 0x08, 0x14, 0x54, 0x54, 0x3C, 0x7F, 0x08,
+    0x04, 0x04, 0x78, 0x44, 0x7D, 0x40, 0x20, 0x40, 0x44, 0x3D, 0x7F, 0x10,
+    0x28, 0x44, 0x41, 0x7F, 0x40, 0x7C, 0x04, 0x18, 0x04, 0x78, 0x7C, 0x08,
+    0x04, 0x04, 0x78, 0x38, 0x44, 0x44, 0x44, 0x38, 0x7C, 0x14, 0x14, 0x14,
+    0x08, 0x08, 0x14, 0x14, 0x18, 0x7C, 0x7C, 0x08, 0x04, 0x04, 0x08, 0x48,
+    0x54, 0x54, 0x54, 0x20, 0x04, 0x3F, 0x44, 0x40, 0x20, 0x3C, 0x40, 0x40,
+    0x20, 0x7C, 0x1C, 0x20, 0x40, 0x20, 0x1C, 0x3C, 0x40, 0x30, 0x40, 0x3C,
+    0x44, 0x28, 0x10, 0x28, 0x44, 0x0C, 0x50, 0x50, 0x50, 0x3C, 0x44, 0x64,
+    0x54, 0x4C, 0x44, 0x08, 0x36, 0x41, 0x7F, 0x41, 0x36, 0x08, 0x08, 0x08,
+    0x2A, 0x1C, 0x08, 0x08, 0x1C, 0x2A, 0x08, 0x08
+};
+
+// lcd_font_digits: characters 0x2D..0x3A of lcd_Font, made with tools/fontpack.c
+// 74 bytes (70 of glyph data, 70 uncompressed)
+rom unsigned char lcd_font_digits[] = {
+    7, 0x2D, 14, 5,
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x30, 0x30, 0x00, 0x00, 0x20, 0x10,
+    0x08, 0x04, 0x02, 0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00, 0x42, 0x7F, 0x40,
+    0x00, 0x42, 0x61, 0x51, 0x49, 0x46, 0x21, 0x41, 0x45, 0x4B, 0x31, 0x18,
+    0x14, 0x12, 0x7F, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39, 0x3C, 0x4A, 0x49,
+    0x49, 0x30, 0x01, 0x71, 0x09, 0x05, 0x03, 0x36, 0x49, 0x49, 0x49, 0x36,
+    0x06, 0x49, 0x49, 0x29, 0x1E, 0x00, 0x36, 0x36, 0x00, 0x00
+};
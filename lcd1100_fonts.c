@@ -0,0 +1,304 @@
+//***************************************************************************
+//  File........: lcd1100_fonts.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Text in several fonts, with proportional glyphs, run-length compressed data and
+//                2x/3x scaling, for the Nokia 1100 LCD
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_lib.c, together with the fonts to use (lcd1100_font2.c or made with
+// tools/fontpack.c). With LCD_NO_FIXED_FONT it also supplies the glyphs of the text functions of the
+// library, see lcd_set_text_font()
+//
+// Font format, a single array in program memory:
+//  byte 0: height of the glyphs in pixels, 1..24
+//  byte 1: code of the first character
+//  byte 2: number of characters
+//  byte 3: width of every glyph for fixed width fonts, 0 for proportional fonts
+//  proportional fonts only:
+//      1 byte per character: width in columns, 1..127, plus LCD_GLYPH_RLE when the data of the
+//      glyph is compressed
+//      2 bytes (low, high) per group of 8 characters: offset of the data of the first one from the
+//      start of the glyph data. The other 7 are found by skipping over the data before them
+//  then the data of every glyph: (height + 7) / 8 lines of "width" bytes each, bit 0 on top like
+//  lcd_Font, or the same bytes compressed with PackBits:
+//      n = 0..127    n + 1 bytes follow as they are
+//      n = 129..255  the next byte is repeated 257 - n times
+
+#ifndef _LCD1100_FONTS_C_
+#define _LCD1100_FONTS_C_
+
+#ifndef LCD_GLYPH_MAX
+#define LCD_GLYPH_MAX 48 // Bytes of the largest glyph (width x lines), e.g. 16 columns of 24 rows
+#endif
+
+#define LCD_GLYPH_RLE 0x80   // Width flag: the data of the glyph is compressed
+#define LCD_FONT_HEADER 4    // Bytes before the table of widths
+#define LCD_FONT_ROWS 24     // Most rows of a scaled glyph
+
+// Current font and size, and the last glyph decoded: font, character and width of it
+static rom unsigned char *lcd_font;
+static unsigned char lcd_font_scale = 1;
+static unsigned char lcd_glyph[LCD_GLYPH_MAX];
+static rom unsigned char *lcd_glyph_font;
+static unsigned char lcd_glyph_code, lcd_glyph_width;
+
+// Font of the text functions of the library built with LCD_NO_FIXED_FONT
+static rom unsigned char *lcd_text_font;
+
+// Function prototypes
+void lcd_set_font(rom unsigned char *font, unsigned char scale);
+void lcd_set_text_font(rom unsigned char *font);
+unsigned char lcd_font_cell(unsigned char c, unsigned char j);
+unsigned char lcd_font_decode(unsigned char c);
+unsigned int16 lcd_font_unpack(unsigned int16 src, unsigned char entry, int1 store);
+unsigned int32 lcd_font_column(unsigned char k, unsigned char width);
+unsigned char lcd_font_char(unsigned char x, unsigned char y, unsigned char c);
+void lcd_font_print(unsigned char x, unsigned char y, char *message);
+unsigned int16 lcd_font_width(char *message);
+
+//******************************************************************************
+// Selects the font and the size of the text drawn from now on
+//  font: font in program memory
+//  scale: 1..3  every pixel of the font becomes scale x scale pixels. Reduced when the glyphs
+//         would be taller than 24 rows
+void lcd_set_font(rom unsigned char *font, unsigned char scale)
+{
+    lcd_font = font;
+
+    if (scale < 1)
+        scale = 1;
+    while (scale > 1 && font[0] * scale > LCD_FONT_ROWS)
+        scale--;
+    lcd_font_scale = scale;
+}
+
+//******************************************************************************
+// Selects the font of print_char(), pix_char(), pix_print() and the modules built on them (console,
+// ticker, display lists) when the library is built with LCD_NO_FIXED_FONT. Until then they draw blanks
+//  font: font in program memory, of 8 rows or less
+void lcd_set_text_font(rom unsigned char *font)
+{
+    lcd_text_font = font;
+}
+
+//******************************************************************************
+// Column of a character of the text font in a cell of 5 columns, for the text functions of the library
+// built with LCD_NO_FIXED_FONT. Narrower glyphs are centered and wider ones cut; only the top 7 rows
+// are drawn. The glyph stays decoded, so the next columns of the same character cost no decoding
+//  c: character code
+//  j: column, 0..4 (5 and more are the empty space after the character)
+unsigned char lcd_font_cell(unsigned char c, unsigned char j)
+{
+    rom unsigned char *font = lcd_font;
+    unsigned char width, k;
+
+    if (j >= 5 || !lcd_text_font)
+        return 0x00;
+
+    lcd_font = lcd_text_font;
+    width = lcd_font_decode(c);
+    lcd_font = font;
+
+    k = j - ((width < 5) ? (5 - width) / 2 : 0);
+    return (k < width) ? lcd_glyph[k] & 0x7F : 0x00;
+}
+
+//******************************************************************************
+// Copies the data of a glyph of the current font to lcd_glyph[], decompressing it if needed. Nothing is
+// done when the glyph is the one decoded last
+//  c: character code
+//  returns the width of the glyph, 0 if the font has no such character or it does not fit in
+//  LCD_GLYPH_MAX bytes
+unsigned char lcd_font_decode(unsigned char c)
+{
+    unsigned char count, lines, entry, g, code = c;
+    unsigned int16 src, i;
+
+    if (lcd_font == lcd_glyph_font && code == lcd_glyph_code)
+        return lcd_glyph_width;
+
+    c -= lcd_font[1];
+    count = lcd_font[2];
+    if (c >= count)
+        return 0; // Before the first character or after the last one
+
+    lines = (lcd_font[0] + 7) / 8;
+
+    if (lcd_font[3])
+    { // Fixed width: no tables, every glyph takes the same bytes
+        entry = lcd_font[3];
+        src = LCD_FONT_HEADER + (unsigned int16)c * entry * lines;
+    }
+    else
+    {
+        src = LCD_FONT_HEADER + count + ((count + 7) / 8) * 2; // Start of the glyph data
+        i = LCD_FONT_HEADER + count + (c / 8) * 2;
+        src += lcd_font[i] | ((unsigned int16)lcd_font[i + 1] << 8);
+        for (g = c & 0xF8; g < c; g++)
+            src = lcd_font_unpack(src, lcd_font[LCD_FONT_HEADER + g], 0);
+        entry = lcd_font[LCD_FONT_HEADER + c];
+    }
+
+    if ((unsigned int16)(entry & ~LCD_GLYPH_RLE) * lines > LCD_GLYPH_MAX)
+        return 0;
+
+    lcd_font_unpack(src, entry, 1);
+    lcd_glyph_font = lcd_font;
+    lcd_glyph_code = code;
+    lcd_glyph_width = entry & ~LCD_GLYPH_RLE;
+    return lcd_glyph_width;
+}
+
+//******************************************************************************
+// Walks over the data of one glyph of the current font
+//  src: index of the data in the font
+//  entry: width of the glyph and LCD_GLYPH_RLE flag
+//  store: 1 - the bytes are copied to lcd_glyph[], 0 - only skipped
+//  returns the index of the data of the next glyph
+unsigned int16 lcd_font_unpack(unsigned int16 src, unsigned char entry, int1 store)
+{
+    unsigned char n, k, value;
+    unsigned int16 size, out;
+
+    size = (unsigned int16)(entry & ~LCD_GLYPH_RLE) * ((lcd_font[0] + 7) / 8);
+
+    if (!(entry & LCD_GLYPH_RLE))
+    {
+        if (store)
+            for (out = 0; out < size; out++)
+                lcd_glyph[out] = lcd_font[src + out];
+        return src + size;
+    }
+
+    for (out = 0; out < size;)
+    {
+        n = lcd_font[src++];
+        if (n < 128)
+        { // n + 1 bytes as they are
+            for (k = 0; k <= n; k++, out++, src++)
+                if (store)
+                    lcd_glyph[out] = lcd_font[src];
+        }
+        else if (n > 128)
+        { // A byte repeated 257 - n times
+            value = lcd_font[src++];
+            for (k = 0; k < (unsigned char)(257 - n); k++, out++)
+                if (store)
+                    lcd_glyph[out] = value;
+        }
+    }
+
+    return src;
+}
+
+//******************************************************************************
+// One column of the decoded glyph, scaled, as a row mask (bit 0 is the top row)
+//  k: column of the glyph
+//  width: width of the glyph
+unsigned int32 lcd_font_column(unsigned char k, unsigned char width)
+{
+    unsigned char row, s;
+    unsigned int32 column, scaled, bit;
+
+    column = lcd_glyph[k];
+    if (lcd_font[0] > 8)
+        column |= (unsigned int32)lcd_glyph[width + k] << 8;
+    if (lcd_font[0] > 16)
+        column |= (unsigned int32)lcd_glyph[2 * width + k] << 16;
+
+    if (lcd_font_scale == 1)
+        return column;
+
+    // Every row is repeated "scale" times
+    scaled = 0;
+    bit = 1;
+    for (row = 0; row < lcd_font[0]; row++)
+        for (s = 0; s < lcd_font_scale; s++, bit <<= 1)
+            if (column & ((unsigned int32)1 << row))
+                scaled |= bit;
+
+    return scaled;
+}
+
+//******************************************************************************
+// Draws a character of the current font with its upper left corner at the given pixel, followed by
+// an empty column. The glyph is written bank by bank as runs of consecutive bytes, replacing the
+// pixels of its cell. Columns out of the screen are not drawn
+//  x: 0..95  horizontal coordinate (counting from the upper left corner)
+//	y: 0..67  vertical coordinate
+//  c: character code
+//  returns the columns taken by the character, 0 if the font does not have it
+unsigned char lcd_font_char(unsigned char x, unsigned char y, unsigned char c)
+{
+    unsigned char width, cols, shift, b, bank, j, k, mask;
+    unsigned int32 area, column;
+
+    width = lcd_font_decode(c);
+    if (!width)
+        return 0;
+
+    LCD_STAT_BEGIN(LCD_STAT_FONT);
+    cols = (width + 1) * lcd_font_scale;
+    shift = y % 8;
+    area = (((unsigned int32)1 << (lcd_font[0] * lcd_font_scale)) - 1) << shift;
+
+    for (b = 0, bank = y / 8; b < 4 && bank < lcd_BANKS; b++, bank++) // 24 rows and the shift fit in 4 banks
+    {
+        mask = area >> (8 * b);
+        if (!mask)
+            break; // Below the character
+        if (bank == lcd_Y_RES / 8)
+            mask &= (1 << (lcd_Y_RES % 8)) - 1;
+
+        for (j = 0; j < cols && x + j < lcd_X_RES; j++)
+        {
+            if (j % lcd_font_scale == 0)
+            { // Next column of the glyph, the last one is the empty column
+                k = j / lcd_font_scale;
+                column = (k < width) ? lcd_font_column(k, width) << shift : 0;
+            }
+            lcd_rop_src[x + j] = column >> (8 * b);
+        }
+        lcd_rop(x, x + j - 1, bank, mask, PIXEL_COPY | LCD_ROP_BITS);
+    }
+    LCD_STAT_END();
+
+    return cols;
+}
+
+//******************************************************************************
+// Display a string of characters in the current font at the specified coordinates in pixels.
+// Characters out of the screen are not drawn, characters missing in the font are skipped
+//  x: 0..95  horizontal coordinate (counting from the upper left corner)
+//	y: 0..67  vertical coordinate
+//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
+void lcd_font_print(unsigned char x, unsigned char y, char *message)
+{
+    for (; *message && x < lcd_X_RES; message++)
+        x += lcd_font_char(x, y, *message);
+}
+
+//******************************************************************************
+// Width in pixels of a string of characters in the current font, to center or right align it
+//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
+unsigned int16 lcd_font_width(char *message)
+{
+    unsigned char c;
+    unsigned int16 width = 0;
+
+    for (; *message; message++)
+    {
+        c = *message - lcd_font[1];
+        if (c < lcd_font[2])
+            width += ((lcd_font[3] ? lcd_font[3] : lcd_font[LCD_FONT_HEADER + c] & ~LCD_GLYPH_RLE) + 1) * lcd_font_scale;
+    }
+
+    return width;
+}
+
+#endif /* _LCD1100_FONTS_C_ */
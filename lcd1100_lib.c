@@ -12,8 +12,13 @@
 #ifndef _LCD1100_LIB_C_
 #define _LCD1100_LIB_C_
 
+// The 5x7 font of the text functions, lcd_Font (480 bytes). It is left out when the pre-shifted font
+// made by tools/fontgen.c is included before (LCD_FONT_SHIFTED), or with LCD_NO_FIXED_FONT defined:
+// the text functions then take their glyphs from a font of lcd1100_fonts.c chosen with
+// lcd_set_text_font(), e.g. lcd_font_prop, so a program that uses that font anyway saves lcd_Font
+#if !defined(LCD_FONT_SHIFTED) && !defined(LCD_NO_FIXED_FONT)
 #include "lcd1100_font1.c"
-#include "dectobin.c"
+#endif
 
 // Port pin numbers to which the LCD controller pins are connected
 #define SCLK PIN_D4
@@ -21,6 +26,87 @@
 #define CS PIN_D6
 #define RST PIN_D7
 
+// Panels on the same bus. They share SCLK, SDA and RST and each one has its own CS pin. For more than
+// one, define LCD_PANELS and the list of their CS pins before including the library, e.g.
+//  #define LCD_PANELS 2
+//  #define LCD_CS_PINS {PIN_D6, PIN_D3}
+// Every panel takes 864 bytes of RAM for its video buffer
+#ifndef LCD_PANELS
+#define LCD_PANELS 1
+#endif
+
+// Write-if-changed policy: uncomment (or define before including the library) to make the drawing
+// functions skip every byte whose value in the video buffer does not change, so redrawing an unchanged
+// screen costs almost no bus traffic. The screen must then always match the video buffer
+//#define LCD_SKIP_UNCHANGED
+
+// Instrumentation: define LCD_STATS before including the library to count, for every kind of
+// primitive, the calls, the CMD and DATA frames sent and the bytes of the video buffer written (see
+// lcd_stats[]). Define lcd_trace(cd, c) to have it called with every frame sent to the controller,
+// e.g. to log the bus on a UART. Both cost nothing when they are not defined
+//#define LCD_STATS
+
+// Transport of the 9-bit frames. LCD_BITBANG drives SCLK and SDA by software, LCD_MSSP uses the
+// hardware SPI module, packing 8 frames into 9 bytes (SCLK and SDA must then be the SCK and SDO pins
+// of the MSSP, PIN_B1 and PIN_C7 on the PIC18F45K50)
+#define LCD_BITBANG 0
+#define LCD_MSSP 1
+
+#ifndef LCD_TRANSPORT
+#define LCD_TRANSPORT LCD_BITBANG
+#endif
+
+// Serial bus timing profile. LCD_SCLK_HZ is the fastest SCLK wanted on the bus and LCD_CPU_HZ the
+// oscillator frequency (taken from #use delay). The bit loop only waits the instruction cycles still
+// missing to respect them and the PCF8814 minimum times below, so with a slow CPU it runs without delays
+#ifndef LCD_SCLK_HZ
+#define LCD_SCLK_HZ 4000000
+#endif
+#ifndef LCD_CPU_HZ
+#define LCD_CPU_HZ getenv("CLOCK")
+#endif
+
+// PCF8814 serial interface minimum times in ns (datasheet AC characteristics, VDD = 2.7 V)
+#define LCD_T_WL 100 // SCLK low
+#define LCD_T_WH 100 // SCLK high
+#define LCD_T_DS 100 // SDA setup before the rising edge of SCLK
+#define LCD_T_DH 100 // SDA hold after the rising edge of SCLK
+
+#define LCD_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LCD_NS_PER_CYCLE (4000000 / (LCD_CPU_HZ / 1000)) // 4 oscillator periods per instruction cycle
+#define LCD_CYCLES(ns) (((ns) + LCD_NS_PER_CYCLE - 1) / LCD_NS_PER_CYCLE)
+#define LCD_T_HALF (500000000 / LCD_SCLK_HZ)
+
+// Cycles SCLK has to stay low (SDA already set) and high. Two instruction cycles of the loop itself
+// are always spent in each half of the period
+#define LCD_LOW_CYCLES LCD_CYCLES(LCD_MAX(LCD_MAX(LCD_T_WL, LCD_T_DS), LCD_T_HALF))
+#define LCD_HIGH_CYCLES LCD_CYCLES(LCD_MAX(LCD_MAX(LCD_T_WH, LCD_T_DH), LCD_T_HALF))
+
+#if LCD_LOW_CYCLES > 257
+#define lcd_delay_low() delay_us((LCD_LOW_CYCLES * LCD_NS_PER_CYCLE + 999) / 1000)
+#elif LCD_LOW_CYCLES > 2
+#define lcd_delay_low() delay_cycles(LCD_LOW_CYCLES - 2)
+#else
+#define lcd_delay_low()
+#endif
+
+#if LCD_HIGH_CYCLES > 257
+#define lcd_delay_high() delay_us((LCD_HIGH_CYCLES * LCD_NS_PER_CYCLE + 999) / 1000)
+#elif LCD_HIGH_CYCLES > 2
+#define lcd_delay_high() delay_cycles(LCD_HIGH_CYCLES - 2)
+#else
+#define lcd_delay_high()
+#endif
+
+// MSSP clock: the fastest division of the CPU clock that does not exceed LCD_SCLK_HZ
+#if LCD_CPU_HZ / 4 <= LCD_SCLK_HZ
+#define LCD_SPI_DIV SPI_CLK_DIV_4
+#elif LCD_CPU_HZ / 16 <= LCD_SCLK_HZ
+#define LCD_SPI_DIV SPI_CLK_DIV_16
+#else
+#define LCD_SPI_DIV SPI_CLK_DIV_64
+#endif
+
 // Macros for working with bits
 #define ClearBit(reg, bit) reg &= (~(1 << (bit)))
 #define SetBit(reg, bit) reg |= (1 << (bit))
@@ -30,96 +116,652 @@
 #define CMD 0
 #define DATA 1
 
-#define PIXEL_ON 0
-#define PIXEL_OFF 1
-#define PIXEL_INV 2
+#define PIXEL_ON 0   // OR: pixels of the source are turned on
+#define PIXEL_OFF 1  // Pixels of the source are turned off
+#define PIXEL_INV 2  // XOR: pixels of the source are inverted
+#define PIXEL_COPY 3 // The source replaces the screen (images, see lcd_combine())
+#define PIXEL_AND 4  // AND: only the screen pixels also set in the source stay on
+#define PIXEL_PATTERN 0x08 // ORed with a mode: the source pixels are those of the shade (lcd_set_shade())
+
+// Flags of the raster-op kernel lcd_rop(), ORed with the pixel mode
+#define LCD_ROP_MODE 0x07 // Pixel mode
+#define LCD_ROP_AREA 0x10 // lcd_rop_src[] holds the pixels of every column the operation covers
+#define LCD_ROP_BITS 0x20 // lcd_rop_src[] holds the source pixels of every column
 
 #define FILL_OFF 0
 #define FILL_ON 1
 
+#define LCD_NO_CHAR 0xFF // Character not in the font, drawn as a blank
+
 #define INV_MODE_ON 0
 #define INV_MODE_OFF 1
 
+#define DEFERRED_OFF 0
+#define DEFERRED_ON 1
+
+// Options of lcd_init_start()
+#define LCD_INIT_FLASH 0x01 // Show the screen inverted for 100 ms after a cold start, as lcd_init()
+#define LCD_INIT_COLD 0x02  // Always reset and clear the panels, even if the video buffer survived
+
+#define WAKE_RAM_KEPT 0 // lcd_wake(): the controller kept its display RAM during the sleep
+#define WAKE_RAM_LOST 1 // lcd_wake(): the controller lost its RAM and registers (supply cut)
+
+// Display mode commands used by lcd_sleep() and lcd_wake() (PCF8814 instruction set). Display off
+// with all points on is the power save mode: oscillator and voltage generator stop, the RAM is kept
+#define LCD_CMD_ALL_NORMAL 0xA4
+#define LCD_CMD_ALL_ON 0xA5
+#define LCD_CMD_DISPLAY_OFF 0xAE
+#define LCD_CMD_DISPLAY_ON 0xAF
+
+// Partial display. The PCF8814 and its clones can drive only a band of rows, with a lower multiplex
+// rate and drive voltage, but the opcodes and their arguments change between controller revisions.
+// Define lcd_partial_cmds(bank1, bank2) before including the library to send the ones from the
+// datasheet of your controller (bank1 = 0 and bank2 = 8 ask for the whole screen); lcd_window() then
+// calls it. Without it the window only limits the banks sent by lcd_flush() and lcd_wake()
+
 // Pixel display resolution
 #define lcd_X_RES 96 // horizontal resolution
 #define lcd_Y_RES 68 // vertical resolution
+#define lcd_BANKS ((lcd_Y_RES / 8) + 1) // banks (lines of 8 pixels) of the video memory
+
+// Outcodes of lcd_outcode(): sides of the screen a point lies beyond
+#define LCD_CLIP_LEFT 0x01
+#define LCD_CLIP_RIGHT 0x02
+#define LCD_CLIP_TOP 0x04
+#define LCD_CLIP_BOTTOM 0x08
+
+// Quadrants of lcd_arc(). The pixels on the axes belong to the quadrants at both sides
+#define ARC_TOP_RIGHT 0x01
+#define ARC_TOP_LEFT 0x02
+#define ARC_BOTTOM_LEFT 0x04
+#define ARC_BOTTOM_RIGHT 0x08
+#define ARC_ALL 0x0F
+#define ARC_TOP (ARC_TOP_RIGHT | ARC_TOP_LEFT)
+#define ARC_BOTTOM (ARC_BOTTOM_LEFT | ARC_BOTTOM_RIGHT)
+#define ARC_LEFT (ARC_TOP_LEFT | ARC_BOTTOM_LEFT)
+#define ARC_RIGHT (ARC_TOP_RIGHT | ARC_BOTTOM_RIGHT)
+
+#define LCD_ELLIPSE_MAX 127 // Largest radius of an ellipse whose radii differ (32-bit border test)
 
 // Video buffer. We work through the buffer, since data cannot be read from the Nokia 1100 controller but for
 // graphics mode we need to know the contents of the video memory (9 banks of 96 bytes each)
-static unsigned char lcd_memory[lcd_X_RES - 1][(lcd_Y_RES / 8) + 1];
-
+//
 // Current coordinates (pointers) in the video buffer
 // lcd_xcurr - in pixels, lcd_ycurr- in banks (lines)
+//
+// Display start row (hardware vertical scroll, see lcd1100_scroll.c)
+//
+// Deferred mode. While it is on, the drawing functions only modify the video buffer and remember, for
+// every bank, the range of columns that changed. lcd_flush() then sends only those ranges to the controller
+#define LCD_CLEAN 0xFF // lcd_dirty_x1 value of a bank without changes
+
+// Window: the banks shown by the panel (see lcd_window()). Changes to the other banks stay marked in
+// the video buffer until they are shown again
+//
+// Sleep: power save mode, and the deferred mode to restore when waking up
+//
+// Mirror of the address pointer of the controller, which moves to the next column after every data
+// byte and to the next bank after column 95. Address settings are only sent for the parts that change.
+// LCD_UNKNOWN: position not known (after reset or a raw address command sent with lcd_write())
+#define LCD_UNKNOWN 0xFF
+
+#if LCD_PANELS > 1
+#ifdef LCD_DOUBLE_BUFFER
+#error LCD_DOUBLE_BUFFER works with a single panel
+#endif
+
+// The state above for every panel. The names used by the library stand for the fields of the panel
+// chosen with lcd_select(), so every function and module draws on it as if it were the only one
+typedef struct
+{
+    unsigned char xcurr, ycurr;
+    int1 deferred;
+    unsigned char dirty_x1[lcd_BANKS], dirty_x2[lcd_BANKS];
+    unsigned char ctl_x, ctl_bank;
+    unsigned char win1, win2;
+    int1 asleep, sleep_deferred;
+} lcd_panel_t;
+
+static lcd_panel_t lcd_panels[LCD_PANELS];
+unsigned char lcd_panel_memory[LCD_PANELS][lcd_X_RES][lcd_BANKS]; // Not static: see lcd_magic
+unsigned char lcd_panel_start_row[LCD_PANELS];                   // Not static: see lcd_magic
+static unsigned char lcd_panel; // Selected panel
+static rom unsigned int16 lcd_cs_pins[LCD_PANELS] = LCD_CS_PINS;
+
+#define lcd_memory lcd_panel_memory[lcd_panel]
+#define lcd_xcurr lcd_panels[lcd_panel].xcurr
+#define lcd_ycurr lcd_panels[lcd_panel].ycurr
+#define lcd_start_row lcd_panel_start_row[lcd_panel]
+#define lcd_deferred lcd_panels[lcd_panel].deferred
+#define lcd_dirty_x1 lcd_panels[lcd_panel].dirty_x1
+#define lcd_dirty_x2 lcd_panels[lcd_panel].dirty_x2
+#define lcd_ctl_x lcd_panels[lcd_panel].ctl_x
+#define lcd_ctl_bank lcd_panels[lcd_panel].ctl_bank
+#define lcd_win1 lcd_panels[lcd_panel].win1
+#define lcd_win2 lcd_panels[lcd_panel].win2
+#define lcd_asleep lcd_panels[lcd_panel].asleep
+#define lcd_sleep_deferred lcd_panels[lcd_panel].sleep_deferred
+#define LCD_CS lcd_cs_pins[lcd_panel]
+#else
+unsigned char lcd_memory[lcd_X_RES][lcd_BANKS]; // Not static: see lcd_magic
 static unsigned char lcd_xcurr, lcd_ycurr;
+unsigned char lcd_start_row; // Not static: see lcd_magic
+static int1 lcd_deferred;
+static unsigned char lcd_dirty_x1[lcd_BANKS], lcd_dirty_x2[lcd_BANKS];
+static unsigned char lcd_ctl_x = LCD_UNKNOWN, lcd_ctl_bank = LCD_UNKNOWN;
+static unsigned char lcd_win1, lcd_win2 = lcd_BANKS - 1;
+static int1 lcd_asleep, lcd_sleep_deferred;
+#define LCD_CS CS
+#endif
+
+static unsigned int16 lcd_cmds_saved; // Address setting commands not sent because they were not needed
+
+#if LCD_TRANSPORT == LCD_MSSP
+// Bits of the last frame that did not fill a whole MSSP byte (from the MSB) and their number
+static unsigned char lcd_spi_acc, lcd_spi_bits;
+#endif
+
+// Staged initialization (lcd_init_start(), lcd_init_poll()): current stage, options, next panel to
+// set up, the start of the current wait and whether the video buffer is restored instead of cleared
+#define LCD_STAGE_READY 0
+#define LCD_STAGE_START 1
+#define LCD_STAGE_RESET 2 // RST low for 5 ms
+#define LCD_STAGE_SETUP 3 // Registers and screen, one panel per call
+#define LCD_STAGE_FLASH 4 // Inverted for 100 ms
+
+static unsigned char lcd_init_stage, lcd_init_options, lcd_init_panel;
+static unsigned int16 lcd_init_time;
+static int1 lcd_init_warm;
+
+// Signature of a valid video buffer, written when the initialization ends. The startup code of CCS
+// clears every static variable, so like lcd_memory and lcd_start_row (the vertical scroll of the
+// screen) it is a global with no static and no initializer: it survives a watchdog or MCLR reset
+// (unless #zero_ram is used) and tells lcd_init_poll() that the screen can be restored from the video
+// buffer. The other state starts over: direct mode, the whole window and the cursor at 0,0
+#define LCD_MAGIC 0x5AC3
+unsigned int16 lcd_magic, lcd_magic_inv;
+
+#ifdef LCD_STATS
+// Kinds of primitive of lcd_stats[]. Calls made by a primitive (the sides of a rectangle, the text of
+// lcd_print()) are charged to it, the frames sent out of any primitive to LCD_STAT_OTHER
+#define LCD_STAT_OTHER 0 // Commands, cursor, scrolling and initialization
+#define LCD_STAT_PIXEL 1 // lcd_pixel()
+#define LCD_STAT_LINE 2  // lcd_line(), lcd_hline(), lcd_vline()
+#define LCD_STAT_RECT 3  // lcd_rectangle()
+#define LCD_STAT_ARC 4   // lcd_arc(), lcd_circle(), lcd_ellipse()
+#define LCD_STAT_TEXT 5  // print_char(), pix_char(), pix_print()
+#define LCD_STAT_BLIT 6  // lcd_blit() (lcd1100_blit.c)
+#define LCD_STAT_FONT 7  // lcd_font_char() (lcd1100_fonts.c)
+#define LCD_STAT_FILL 8  // lcd_clear(), lcd_fill(), lcd_fill_bank()
+#define LCD_STAT_FLUSH 9 // lcd_flush(), lcd_flush_all()
+#define LCD_STAT_KINDS 10
+
+typedef struct
+{
+    unsigned int16 calls; // Calls of the primitive
+    unsigned int16 cmd;   // CMD frames sent
+    unsigned int16 data;  // DATA frames sent
+    unsigned int16 bytes; // Bytes of the video buffer written
+} lcd_stat_t;
+
+lcd_stat_t lcd_stats[LCD_STAT_KINDS];
+static unsigned char lcd_stat_kind, lcd_stat_depth; // Primitive being drawn and nesting of the calls
+
+#define LCD_STAT_BEGIN(kind) lcd_stat_begin(kind)
+#define LCD_STAT_END() lcd_stat_end()
+#define LCD_STAT_BYTES(n) lcd_stats[lcd_stat_kind].bytes += (n)
+#else
+#define LCD_STAT_BEGIN(kind)
+#define LCD_STAT_END()
+#define LCD_STAT_BYTES(n)
+#endif
+
+// Position of the next byte of a run of consecutive bytes in one bank (see lcd_run_start())
+static unsigned char lcd_run_x, lcd_run_bank;
+
+// Raster-op kernel: pixels of every column for LCD_ROP_AREA or LCD_ROP_BITS, and the shade used with
+// PIXEL_PATTERN as 4 column bytes repeated across the screen (bit 0 on top)
+static unsigned char lcd_rop_src[lcd_X_RES];
+static unsigned char lcd_shade[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+// Ordered dither matrix of lcd_set_shade(): a pixel is on when its entry is below the level
+static rom unsigned char lcd_bayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}};
+
+// Half width of every row of the ellipse being drawn by lcd_arc(), -1 for the rows it does not reach.
+// Entry 0 is the row above the screen and entry lcd_Y_RES + 1 the row below it
+static signed int16 lcd_arc_w[lcd_Y_RES + 2];
+
+#ifdef LCD_DOUBLE_BUFFER
+// Double buffering. lcd_swap() copies the video buffer into the front buffer, which the SSP interrupt
+// streams to the controller while the program keeps drawing the next frame in lcd_memory.
+// Needs 864 more bytes of RAM, LCD_TRANSPORT == LCD_MSSP and the global interrupts enabled
+// (with the bit-bang transport lcd_swap() sends the frame before returning)
+static unsigned char lcd_front[lcd_X_RES][lcd_BANKS];
+static unsigned char lcd_async_x, lcd_async_bank; // Next byte of the front buffer to be sent
+static int1 lcd_async_busy;
+
+#if LCD_TRANSPORT == LCD_MSSP
+#byte lcd_SSPBUF = getenv("SFR:SSP1BUF") // MSSP buffer register, written directly by the interrupt
+#endif
+#endif
 
 // Function prototypes
 void lcd_init(void);
+void lcd_init_start(unsigned char options);
+int1 lcd_init_poll(unsigned int16 now_ms);
+void lcd_configure(void);
+void lcd_select(unsigned char panel);
+void lcd_window(unsigned char bank1, unsigned char bank2);
+void lcd_sleep(void);
+void lcd_wake(int1 ram);
 void lcd_write(int1 cd, unsigned char c);
+void lcd_send(int1 cd, unsigned char c);
+void lcd_bus_start(void);
+void lcd_bus_frame(int1 cd, unsigned char c);
+void lcd_bus_stop(void);
+void lcd_bus_select(unsigned char panel);
+void lcd_address(unsigned char x, unsigned char bank);
 void lcd_clear(void);
+void lcd_fill(unsigned char pattern);
+void lcd_fill_bank(unsigned char bank, unsigned char pattern);
+void lcd_set_deferred(int1 mode);
+int1 lcd_get_deferred(void);
+void lcd_mark(unsigned char x1, unsigned char x2, unsigned char bank);
+void lcd_flush(void);
+void lcd_flush_bank(unsigned char bank);
+void lcd_flush_all(void);
+#ifdef LCD_STATS
+void lcd_stats_clear(void);
+void lcd_stat_begin(unsigned char kind);
+void lcd_stat_end(void);
+#endif
+#ifdef LCD_DOUBLE_BUFFER
+void lcd_swap(void);
+int1 lcd_busy(void);
+#if LCD_TRANSPORT == LCD_MSSP
+void lcd_ssp_isr(void);
+#endif
+#endif
 void setx(char x);
 void sety(char y);
 void gotoxy(char x, char y);
 void lcd_inverse(unsigned int1 mode);
 void lcd_gotoxy_pix(char x, char y);
+void lcd_pixel(signed int16 x, signed int16 y, unsigned char pixel_mode);
+void lcd_plot(unsigned char x, unsigned char y, unsigned char pixel_mode);
+void lcd_run_start(unsigned char x, unsigned char bank);
+void lcd_run_put(unsigned char c);
 void pix_char(unsigned char x, unsigned char y, unsigned char c);
-void lcd_line(unsigned char x1, unsigned char y1, unsigned char x2, unsigned char y2, unsigned char pixel_mode);
-void lcd_circle(unsigned char x, unsigned char y, unsigned char radius, unsigned char fill, int pixel_mode);
-void lcd_rectangle(unsigned char x1, unsigned char y1, unsigned char x2, unsigned char y2, unsigned char fill, unsigned char pixel_mode);
-void print_char(char c);
+void pix_print(unsigned char x, unsigned char y, char *message);
+void lcd_text(signed int16 x, signed int16 y, char *message, unsigned char width);
+void lcd_text_run(signed int16 x, unsigned char bank, char *message, unsigned char shift, int1 next, unsigned char width);
+unsigned char lcd_char_index(unsigned char c);
+unsigned char lcd_char_column(unsigned char g, unsigned char j);
+#ifdef LCD_NO_FIXED_FONT
+unsigned char lcd_font_cell(unsigned char c, unsigned char j); // lcd1100_fonts.c
+#endif
+unsigned char lcd_combine(unsigned char old, unsigned char bits, unsigned char area, unsigned char pixel_mode);
+unsigned char lcd_bank_mask(unsigned char bank, unsigned char y1, unsigned char y2);
+void lcd_rop(unsigned char x1, unsigned char x2, unsigned char bank, unsigned char mask, unsigned char op);
+void lcd_set_shade(unsigned char level);
+void lcd_hline(signed int16 x1, signed int16 x2, signed int16 y, unsigned char pixel_mode);
+void lcd_vline(signed int16 x, signed int16 y1, signed int16 y2, unsigned char pixel_mode);
+unsigned char lcd_outcode(signed int16 x, signed int16 y);
+void lcd_line(signed int16 x1, signed int16 y1, signed int16 x2, signed int16 y2, unsigned char pixel_mode);
+int1 lcd_arc_inside(unsigned int16 dx, unsigned int16 dy, unsigned int32 a, unsigned int32 b, unsigned int32 c);
+void lcd_arc(signed int16 x, signed int16 y, unsigned char rx, unsigned char ry, unsigned char quadrants, unsigned char fill, unsigned char pixel_mode);
+void lcd_circle(signed int16 x, signed int16 y, unsigned char radius, unsigned char fill, unsigned char pixel_mode);
+void lcd_ellipse(signed int16 x, signed int16 y, unsigned char rx, unsigned char ry, unsigned char fill, unsigned char pixel_mode);
+void lcd_rectangle(signed int16 x1, signed int16 y1, signed int16 x2, signed int16 y2, unsigned char fill, unsigned char pixel_mode);
+void print_char(unsigned char c);
 
 //******************************************************************************
-// Controller initialization
+// Controller initialization, blocking: resets and clears the panels and shows them inverted for 100 ms.
+// With several panels all of them are reset together and initialized one after the other, and panel 0
+// is selected at the end. See lcd_init_start() for a start that does not block
 void lcd_init(void)
 {
-    output_low(CS);
-    output_low(RST);
-    delay_ms(5); // Wait at least 5ms to install the generator (less than 5 ms may not work)
-    output_high(RST);
+    unsigned int16 ms;
+
+    lcd_init_start(LCD_INIT_COLD | LCD_INIT_FLASH);
+    for (ms = 0; !lcd_init_poll(ms); ms++)
+        delay_ms(1);
+}
+
+//******************************************************************************
+// Starts the initialization without blocking; call lcd_init_poll() from the main loop until it returns
+// 1, and draw nothing before. If the video buffer survived a reset of the PIC (watchdog, MCLR) the
+// panels are not reset: their registers are set again and the screen is sent from the video buffer,
+// so it comes back in a few ms with no blank screen and no flash
+//  options: LCD_INIT_FLASH, LCD_INIT_COLD, both ORed or 0
+void lcd_init_start(unsigned char options)
+{
+    lcd_init_options = options;
+    lcd_init_stage = LCD_STAGE_START;
+}
+
+//******************************************************************************
+// Does the next step of the initialization started by lcd_init_start(). The waits are measured with
+// the time given, so the call returns at once while a wait is not over
+//  now_ms: a free running millisecond counter, may wrap around
+//  returns 1 when the panels are ready
+int1 lcd_init_poll(unsigned int16 now_ms)
+{
+    unsigned char panel, bank;
+
+    switch (lcd_init_stage)
+    {
+    case LCD_STAGE_START:
+#if LCD_TRANSPORT == LCD_MSSP
+        setup_spi(SPI_MASTER | SPI_L_TO_H | SPI_XMIT_L_TO_H | LCD_SPI_DIV); // Data sampled on the rising edge
+#endif
+        lcd_init_warm = !(lcd_init_options & LCD_INIT_COLD) && lcd_magic == LCD_MAGIC &&
+                        lcd_magic_inv == (unsigned int16)~LCD_MAGIC;
+        lcd_magic = 0; // Not valid until the end
+
+        for (panel = 0; panel < LCD_PANELS; panel++)
+        {
+            lcd_select(panel);
+            lcd_ctl_x = LCD_UNKNOWN;
+            lcd_ctl_bank = LCD_UNKNOWN;
+            output_low(LCD_CS); // CS going high again drops any frame cut by the reset of the PIC
+        }
+        if (!lcd_init_warm)
+            output_low(RST);
+
+        lcd_init_time = now_ms;
+        lcd_init_panel = 0;
+        lcd_init_stage = LCD_STAGE_RESET;
+        return 0;
+
+    case LCD_STAGE_RESET:
+        if (!lcd_init_warm)
+        {
+            if ((unsigned int16)(now_ms - lcd_init_time) < 5)
+                return 0; // Wait at least 5ms to install the generator (less than 5 ms may not work)
+            output_high(RST);
+        }
+
+        for (panel = 0; panel < LCD_PANELS; panel++)
+        {
+            lcd_select(panel);
+            output_high(LCD_CS); // Every panel only listens to its own commands from now on
+        }
+        lcd_init_stage = LCD_STAGE_SETUP;
+        return 0;
+
+    case LCD_STAGE_SETUP:
+        lcd_select(lcd_init_panel);
+        lcd_deferred = 0;
+        lcd_win1 = 0;
+        lcd_win2 = lcd_BANKS - 1;
+        lcd_asleep = 0;
+        lcd_configure();
+
+        if (lcd_init_warm)
+        { // The whole video buffer, then the display on
+            lcd_write(CMD, 0x40 | lcd_start_row);
+            for (bank = 0; bank < lcd_BANKS; bank++)
+            {
+                lcd_dirty_x1[bank] = 0;
+                lcd_dirty_x2[bank] = lcd_X_RES - 1;
+            }
+            lcd_flush();
+            lcd_write(CMD, 0xAF); // Display ON/OFF
+            lcd_gotoxy_pix(lcd_xcurr, lcd_ycurr * 8);
+        }
+        else
+        {
+            lcd_write(CMD, 0xAF); // Display ON/OFF
+            lcd_clear();          // Clear LCD
+            if (lcd_init_options & LCD_INIT_FLASH)
+                lcd_write(CMD, 0xA7); // Invert display
+        }
+
+        if (++lcd_init_panel < LCD_PANELS)
+            return 0;
+
+        lcd_select(0);
+        lcd_init_time = now_ms;
+        if (!lcd_init_warm && (lcd_init_options & LCD_INIT_FLASH))
+        {
+            lcd_init_stage = LCD_STAGE_FLASH;
+            return 0;
+        }
+        break;
+
+    case LCD_STAGE_FLASH:
+        if ((unsigned int16)(now_ms - lcd_init_time) < 100)
+            return 0;
+
+        for (panel = 0; panel < LCD_PANELS; panel++)
+        {
+            lcd_select(panel);
+            lcd_write(CMD, 0xA6); // Normal display (non inverted)
+        }
+        lcd_select(0);
+        break;
+
+    default:
+        return 1;
+    }
+
+    lcd_magic = LCD_MAGIC;
+    lcd_magic_inv = ~LCD_MAGIC;
+    lcd_init_stage = LCD_STAGE_READY;
+    return 1;
+}
+
+//******************************************************************************
+// Sets the registers of the controller after a reset, leaving the display off
+void lcd_configure(void)
+{
     lcd_write(CMD, 0x20); // write VOP register
     lcd_write(CMD, 0x90);
     lcd_write(CMD, 0xA4); // All on/normal display
     lcd_write(CMD, 0x2F); // Power control set(charge pump on/oFF)
     lcd_write(CMD, 0x40); // Set start row address = 0
-    lcd_write(CMD, 0xB0); // Set Y-address = 0
-    lcd_write(CMD, 0x10); // Set X-address, upper 3 bits
-    lcd_write(CMD, 0x00); // Set X-address, lower 4 bits
     lcd_write(CMD, 0xC8); // Mirror Y axis (about X axis) [change 0xC8 for 0xC0 for mirroring]
     lcd_write(CMD, 0xA1); // Invert screen in horizontal axis
     lcd_write(CMD, 0xAC); // Set initial row (R0) of the display
     lcd_write(CMD, 0x07);
-    lcd_write(CMD, 0xAF); // Display ON/OFF
+    lcd_write(CMD, 0xB0); // Set Y-address = 0
+    lcd_write(CMD, 0x10); // Set X-address, upper 3 bits
+    lcd_write(CMD, 0x00); // Set X-address, lower 4 bits
 
-    lcd_clear();          // Clear LCD
-    lcd_write(CMD, 0xA7); // Invert display
-    delay_ms(100);
-    lcd_write(CMD, 0xA6); // Normal display (non inverted)
-    delay_ms(100);
+    // The pointer is at 0,0: the address commands come last, after the 0x07 argument that looks like
+    // one, and lcd_write() forgot the position when it sent them
+    lcd_ctl_x = 0;
+    lcd_ctl_bank = 0;
 }
 
 //******************************************************************************
-// Screen cleaning
-void lcd_clear(void)
+// Selects the panel the following calls work on: drawing, cursor, deferred mode, lcd_flush()...
+// Each panel keeps its own video buffer and state. Does nothing with a single panel
+//  panel: 0..LCD_PANELS-1
+void lcd_select(unsigned char panel)
+{
+#if LCD_PANELS > 1
+    if (panel < LCD_PANELS)
+        lcd_panel = panel;
+#else
+    (void)panel; // Always panel 0
+#endif
+}
+
+//******************************************************************************
+// Sets the window of banks shown by the panel. Only its banks are sent by lcd_flush() and lcd_wake();
+// changes to the others stay marked and go out when the window takes them in again, so the cost of
+// refreshing the screen follows the size of the window. With lcd_partial_cmds() defined the panel
+// also stops driving the other rows
+//  bank1, bank2: 0..8  first and last bank of the window, 0 and 8 for the whole screen
+void lcd_window(unsigned char bank1, unsigned char bank2)
+{
+    unsigned char temp;
+
+    if (bank1 > bank2)
+    {
+        temp = bank1;
+        bank1 = bank2;
+        bank2 = temp;
+    }
+    if (bank2 >= lcd_BANKS)
+        bank2 = lcd_BANKS - 1;
+    if (bank1 > bank2)
+        bank1 = bank2;
+
+    lcd_win1 = bank1;
+    lcd_win2 = bank2;
+#ifdef lcd_partial_cmds
+    lcd_partial_cmds(bank1, bank2);
+#endif
+
+    if (!lcd_deferred)
+        lcd_flush(); // Changes kept back while the banks were out of the window
+}
+
+//******************************************************************************
+// Puts the panel in power save mode. The display RAM is kept; the drawing functions only change the
+// video buffer until lcd_wake(), as in deferred mode
+void lcd_sleep(void)
+{
+    if (lcd_asleep)
+        return;
+
+    lcd_write(CMD, LCD_CMD_DISPLAY_OFF);
+    lcd_write(CMD, LCD_CMD_ALL_ON); // Display off and all points on: power save
+
+    lcd_sleep_deferred = lcd_deferred;
+    lcd_deferred = 1;
+    lcd_asleep = 1;
+}
+
+//******************************************************************************
+// Leaves the power save mode and sends the banks of the window that changed while sleeping, then turns
+// the display on. If the controller lost its RAM (its supply was cut during the sleep) the registers
+// are set again and the whole window is sent from the video buffer; the banks out of the window are
+// marked and sent when they are shown again. In both cases the screen matches the video buffer
+//  ram: WAKE_RAM_KEPT or WAKE_RAM_LOST
+void lcd_wake(int1 ram)
 {
-    unsigned int i;
+    unsigned char bank;
+
+    if (ram == WAKE_RAM_LOST)
+    {
+        lcd_ctl_x = LCD_UNKNOWN;
+        lcd_ctl_bank = LCD_UNKNOWN;
+        lcd_configure();
+        lcd_write(CMD, 0x40 | lcd_start_row); // The scroll position of the video buffer
+#ifdef lcd_partial_cmds
+        lcd_partial_cmds(lcd_win1, lcd_win2);
+#endif
+        for (bank = 0; bank < lcd_BANKS; bank++)
+            lcd_mark(0, lcd_X_RES - 1, bank);
+    }
+    else
+        lcd_write(CMD, LCD_CMD_ALL_NORMAL);
+
+    lcd_flush();
+    lcd_write(CMD, LCD_CMD_DISPLAY_ON);
 
-    lcd_write(CMD, 0x40); // Y = 0
-    lcd_write(CMD, 0xB0);
-    lcd_write(CMD, 0x10); // X = 0
-    lcd_write(CMD, 0x00);
+    if (lcd_asleep)
+    {
+        lcd_asleep = 0;
+        lcd_deferred = lcd_sleep_deferred;
+        if (!lcd_deferred)
+            lcd_gotoxy_pix(lcd_xcurr, lcd_ycurr * 8); // The controller pointer follows the video buffer again
+    }
+}
 
+//******************************************************************************
+// Screen cleaning
+void lcd_clear(void)
+{
+    LCD_STAT_BEGIN(LCD_STAT_FILL);
     lcd_xcurr = 0;
     lcd_ycurr = 0; // Set to 0 the current coordinates in the video buffer
 
+    if (lcd_deferred)
+    { // Only the video buffer is cleared, the whole screen is sent by the next lcd_flush()
+        lcd_fill(0x00);
+        LCD_STAT_END();
+        return;
+    }
+
+    lcd_start_row = 0;
+    lcd_write(CMD, 0x40); // Start row = 0
     lcd_write(CMD, 0xAE); // Disable display
-    for (i = 0; i < 255; i++)
-        lcd_write(DATA, 0x00);
-    for (i = 0; i < 255; i++)
-        lcd_write(DATA, 0x00);
-    for (i = 0; i < 255; i++)
-        lcd_write(DATA, 0x00);
-    for (i = 0; i < 99; i++)
-        lcd_write(DATA, 0x00);
+    lcd_fill(0x00);
     lcd_write(CMD, 0xAF); // Enable display
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Fills the whole screen with a pattern, in a single burst: the controller goes on to the next bank
+// after the last column, so one address setting is enough. The bytes are always sent, the screen may
+// hold anything (after a reset for example)
+//  pattern: value of every byte (8 vertical pixels, bit 0 on top)
+void lcd_fill(unsigned char pattern)
+{
+    unsigned char bank, x;
+
+    LCD_STAT_BEGIN(LCD_STAT_FILL);
+    memset(lcd_memory, pattern, sizeof(lcd_memory));
+    LCD_STAT_BYTES(sizeof(lcd_memory));
+
+    for (bank = 0; bank < lcd_BANKS; bank++)
+    {
+        if (lcd_deferred)
+            lcd_mark(0, lcd_X_RES - 1, bank);
+        else
+            lcd_dirty_x1[bank] = LCD_CLEAN; // The screen is about to match the video buffer
+    }
+
+    if (!lcd_deferred)
+    {
+        lcd_bus_start();
+        lcd_address(0, 0);
+        for (bank = 0; bank < lcd_BANKS; bank++)
+            for (x = 0; x < lcd_X_RES; x++)
+                lcd_bus_frame(DATA, pattern);
+        lcd_bus_stop();
+    }
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Fills one bank (line of 8 pixels) with a pattern, in a single burst
+//  bank: 0..8  (other values are ignored)
+//  pattern: value of every byte (8 vertical pixels, bit 0 on top)
+void lcd_fill_bank(unsigned char bank, unsigned char pattern)
+{
+    unsigned char x;
+
+    if (bank >= lcd_BANKS)
+        return;
+
+    LCD_STAT_BEGIN(LCD_STAT_FILL);
+    for (x = 0; x < lcd_X_RES; x++)
+        lcd_memory[x][bank] = pattern;
+    LCD_STAT_BYTES(lcd_X_RES);
+
+    if (lcd_deferred)
+        lcd_mark(0, lcd_X_RES - 1, bank);
+    else
+    {
+        lcd_bus_start();
+        lcd_address(0, bank);
+        for (x = 0; x < lcd_X_RES; x++)
+            lcd_bus_frame(DATA, pattern);
+        lcd_bus_stop();
+
+        lcd_dirty_x1[bank] = LCD_CLEAN;
+    }
+    LCD_STAT_END();
 }
 
 //******************************************************************************
@@ -127,14 +769,20 @@ void lcd_clear(void)
 //  mode: CMD - pass the command
 //		  DATA - transfer data
 //  c: value of transmitted byte
+// In deferred mode data is only written to the video buffer and marked for lcd_flush()
 void lcd_write(int1 cd, unsigned char c)
 {
-    output_low(CS);
-    output_low(SCLK);
+    unsigned char x = lcd_xcurr, bank = lcd_ycurr;
 
     if (cd == 1)
     {
-        lcd_memory[lcd_xcurr][lcd_ycurr] = c; // Write data to the video buffer
+        if (x >= lcd_X_RES || bank >= lcd_BANKS)
+            return; // No cursor of the setters gets here: the video buffer is never written out of its bounds
+#ifdef LCD_SKIP_UNCHANGED
+        int1 same = (lcd_memory[x][bank] == c);
+#endif
+        lcd_memory[x][bank] = c; // Write data to the video buffer
+        LCD_STAT_BYTES(1);
 
         lcd_xcurr++; // Update the coordinates in the video buffer
 
@@ -146,317 +794,1248 @@ void lcd_write(int1 cd, unsigned char c)
 
         if (lcd_ycurr > 8)
             lcd_ycurr = 0;
-        output_high(SDA);
+
+#ifdef LCD_SKIP_UNCHANGED
+        // The controller pointer stays behind over the unchanged bytes and is moved to the cursor
+        // before the next byte sent (if its position is not known nothing is skipped)
+        if (same && (lcd_deferred || lcd_ctl_x != LCD_UNKNOWN))
+            return;
+#endif
+
+        if (lcd_deferred)
+        {
+            lcd_mark(x, x, bank);
+            return;
+        }
+    }
+
+    lcd_bus_start();
+    if (cd == 1 && lcd_ctl_x != LCD_UNKNOWN && (lcd_ctl_x != x || lcd_ctl_bank != bank))
+        lcd_address(x, bank); // The controller pointer was moved by a burst or left behind by skipped bytes
+    lcd_bus_frame(cd, c);
+    lcd_bus_stop();
+
+    if (cd == 0 && (c <= 0x17 || (c & 0xF0) == 0xB0))
+    { // An address command (or the argument of another command that looks like one) sent from outside
+      // lcd_address(): the position of the controller pointer is no longer known
+        lcd_ctl_x = LCD_UNKNOWN;
+        lcd_ctl_bank = LCD_UNKNOWN;
     }
+}
+
+//******************************************************************************
+// Transfer of one 9-bit frame (CMD or DATA) to the LCD controller, without touching the video buffer
+//  cd: CMD or DATA
+//  c: value of transmitted byte
+void lcd_send(int1 cd, unsigned char c)
+{
+    lcd_bus_start();
+    lcd_bus_frame(cd, c);
+    lcd_bus_stop();
+}
+
+//******************************************************************************
+// Start of a burst of frames: selects the controller, which stays selected until lcd_bus_stop()
+void lcd_bus_start(void)
+{
+#ifdef LCD_DOUBLE_BUFFER
+    while (lcd_async_busy)
+        ; // The bus belongs to the frame being sent in the background
+#endif
+    output_low(LCD_CS);
+#if LCD_TRANSPORT == LCD_BITBANG
+    output_low(SCLK);
+#endif
+}
+
+//******************************************************************************
+// Transfer of one 9-bit frame inside a burst
+//  cd: CMD or DATA
+//  c: value of transmitted byte
+void lcd_bus_frame(int1 cd, unsigned char c)
+{
+#ifdef LCD_STATS
+    if (cd)
+        lcd_stats[lcd_stat_kind].data++;
     else
-    {
-        output_low(SDA);
+        lcd_stats[lcd_stat_kind].cmd++;
+#endif
+#ifdef lcd_trace
+    lcd_trace(cd, c);
+#endif
+
+    if (cd && lcd_ctl_x != LCD_UNKNOWN && ++lcd_ctl_x == lcd_X_RES)
+    { // The controller pointer moves on after every data byte
+        lcd_ctl_x = 0;
+        if (++lcd_ctl_bank == lcd_BANKS)
+            lcd_ctl_bank = 0;
+    }
+
+#if LCD_TRANSPORT == LCD_MSSP
+    if (cd)
+        lcd_spi_acc |= 0x80 >> lcd_spi_bits; // The first bit tells the controller if the byte is a command or data
+
+    if (++lcd_spi_bits == 8)
+    { // Every 8 frames the extra bits make up a whole byte
+        spi_write(lcd_spi_acc);
+        lcd_spi_acc = 0;
+        lcd_spi_bits = 0;
     }
 
-    output_low(CS);
+    spi_write(lcd_spi_acc | (c >> lcd_spi_bits));
+    if (lcd_spi_bits)
+        lcd_spi_acc = c << (8 - lcd_spi_bits); // The low bits of c wait for the next byte
+    else
+        lcd_spi_acc = 0;
+#else
     output_low(SCLK);
-    output_bit(SDA, cd);
+    output_bit(SDA, cd); // The first bit tells the controller if the byte is a command or data
+    lcd_delay_low();
     output_high(SCLK);
 
     for (unsigned char i = 0; i < 8; i++)
     {
+        lcd_delay_high();
         output_low(SCLK);
         if ((c & 0x80))
             output_high(SDA);
         else
             output_low(SDA);
+        lcd_delay_low();
         output_high(SCLK);
         c <<= 1;
-        delay_us(34);
     }
-    output_high(CS);
+    lcd_delay_high();
+#endif
 }
 
 //******************************************************************************
-// Sets the cursor to the desired position. The countdown begins in the
-// upper left corner. Horizontal 16 familiarity, vertical - 8
-//  x: 0..15
-//  y: 0..7
-void gotoxy(char x, char y)
+// Places the controller pointer inside a burst. Only the commands for the parts of the address that
+// differ from the current position are sent (Y, X lower 4 bits, X upper 3 bits)
+//  x: 0..95
+//  bank: 0..8
+void lcd_address(unsigned char x, unsigned char bank)
 {
-    x = x * 6; // We pass from the coordinate in familiarity to the coordinates in pixels
+    int1 known = (lcd_ctl_x != LCD_UNKNOWN);
 
-    lcd_xcurr = x;
-    lcd_ycurr = y;
+    if (!known || bank != lcd_ctl_bank)
+        lcd_bus_frame(CMD, (0xB0 | (bank & 0x0F))); // Y address setting: 0100 yyyy
+    else
+        lcd_cmds_saved++;
+
+    if (!known || ((x ^ lcd_ctl_x) & 0x0F))
+        lcd_bus_frame(CMD, (0x00 | (x & 0x0F))); // X address setting: 0000 xxxx - bits (x3 x2 x1 x0)
+    else
+        lcd_cmds_saved++;
+
+    if (!known || ((x ^ lcd_ctl_x) & 0x70))
+        lcd_bus_frame(CMD, (0x10 | ((x >> 4) & 0x07))); // X address setting: 0010 0xxx - bits (x6 x5 x4)
+    else
+        lcd_cmds_saved++;
 
-    //lcd_write(CMD, (0xB0 | (y & 0x0F))); // Y axis initialisation: 0100 yyyy
-    lcd_write(CMD, (0xB0 | (y & 0x0F)));        // Y axis initialisation: 0100 yyyy
-    lcd_write(CMD, (0x00 | (x & 0x0F)));        // X axis initialisation: 0000 xxxx ( x3 x2 x1 x0)
-    lcd_write(CMD, (0x10 | ((x >> 4) & 0x07))); // X axis initialisation: 0010 0xxx  ( x6 x5 x4)
+    lcd_ctl_x = x;
+    lcd_ctl_bank = bank;
 }
 
 //******************************************************************************
-// Set the inversion mode of the entire screen. Data on the screen does not change, only inverted
-//  mode: INV_MODE_ON or INV_MODE_OFF
-void lcd_inverse(unsigned char mode)
+// End of a burst of frames: deselects the controller
+void lcd_bus_stop(void)
 {
-    if (mode)
-        lcd_write(CMD, 0xA6);
-    else
-        lcd_write(CMD, 0xA7);
+#if LCD_TRANSPORT == LCD_MSSP
+    if (lcd_spi_bits)
+    { // The pending bits are completed with zeros. They form an unfinished frame, which the
+      // controller discards when CS goes high
+        spi_write(lcd_spi_acc);
+        lcd_spi_acc = 0;
+        lcd_spi_bits = 0;
+    }
+#endif
+    output_high(LCD_CS);
 }
 
 //******************************************************************************
-// Sets the cursor in pixels. The countdown begins in the upper
-// left corner. 96 pixels horizontally, 65 pixels vertically
-//  x: 0..95
-//  y: 0..64
-void lcd_gotoxy_pix(char x, char y)
+// Hands a burst over to another panel: the current one is deselected and the new one selected,
+// without setting up the bus again. Selects the panel like lcd_select()
+//  panel: 0..LCD_PANELS-1
+void lcd_bus_select(unsigned char panel)
 {
-    lcd_xcurr = x;
-    lcd_ycurr = y / 8;
-
-    lcd_write(CMD, (0xB0 | (lcd_ycurr & 0x0F))); // Y address setting: 0100 yyyy
-    lcd_write(CMD, (0x00 | (x & 0x0F)));         // X address setting: 0000 xxxx - bits (x3 x2 x1 x0)
-    lcd_write(CMD, (0x10 | ((x >> 4) & 0x07)));  // X address setting: 0010 0xxx - bits (x6 x5 x4)
+#if LCD_PANELS > 1
+#if LCD_TRANSPORT == LCD_MSSP
+    if (lcd_spi_bits)
+    { // The bits of the last frame must reach the panel they belong to
+        spi_write(lcd_spi_acc);
+        lcd_spi_acc = 0;
+        lcd_spi_bits = 0;
+    }
+#endif
+    output_high(LCD_CS);
+    lcd_select(panel);
+    output_low(LCD_CS);
+#else
+    (void)panel; // Always panel 0
+#endif
 }
 
 //******************************************************************************
-// Conclusion of a point on the Nokia 1100 LCD screen
-//  x: 0..95  horizontal coordinate (counting from the upper left corner)
-//	y: 0..64  vertical coordinate
-//	pixel_mode: PIXEL_ON  - to enable pixel
-//				PIXEL_OFF - to turn off the pixel
-//				PIXEL_INV - to invert a pixel
-void lcd_pixel(unsigned char x, unsigned char y, unsigned char pixel_mode)
+// Switches the deferred mode. Turning it off sends the pending changes to the screen
+//  mode: DEFERRED_ON or DEFERRED_OFF
+void lcd_set_deferred(int1 mode)
 {
-    unsigned char temp;
-
-    lcd_gotoxy_pix(x, y);
-    temp = lcd_memory[lcd_xcurr][lcd_ycurr];
+    if (lcd_asleep)
+    { // Taken up by lcd_wake()
+        lcd_sleep_deferred = mode;
+        return;
+    }
 
-    switch (pixel_mode)
+    if (mode)
     {
-    case PIXEL_ON:
-        SetBit(temp, y % 8); // Turn on the pixel
-        break;
-    case PIXEL_OFF:
-        ClearBit(temp, y % 8); // Turn off the pixel
-        break;
-    case PIXEL_INV:
-        InvBit(temp, y % 8); // Invert pixel
-        break;
+        lcd_deferred = 1;
+        return;
     }
 
-    lcd_memory[lcd_xcurr][lcd_ycurr] = temp; // transfer the byte to the video buffer
-    lcd_write(DATA, temp);                   // We pass the byte to the controller
+    lcd_flush();
+    lcd_deferred = 0;
+    lcd_gotoxy_pix(lcd_xcurr, lcd_ycurr * 8); // The controller pointer follows the video buffer again
 }
 
 //******************************************************************************
-// Display a character on the NOKIA 1100 LCD screen at the specified coordinates in pixels
-//  c: character code
-//  x: 0..95  horizontal coordinate (counting from the upper left corner)
-//	y: 0..64  vertical coordinate
-void pix_char(unsigned char x, unsigned char y, unsigned char c)
+// Deferred mode chosen with lcd_set_deferred(). While the panel sleeps the drawing functions are
+// always deferred, and this is the mode lcd_wake() goes back to
+//  returns DEFERRED_ON or DEFERRED_OFF
+int1 lcd_get_deferred(void)
 {
-    for (unsigned char j = 0; j < 5; j++)
-    {
-        dectobin(lcd_Font[c - 0x20][j]);
-        for (unsigned char k = 0; k < 7; k++)
-        {
-            if (bin[k] == 1)
-            {
-                lcd_pixel(x + j, y + k, PIXEL_ON);
-            }
-            else
-            {
-                lcd_pixel(x + j, y + k, PIXEL_OFF);
-            }
-        }
-    }
+    return lcd_asleep ? lcd_sleep_deferred : lcd_deferred;
 }
 
 //******************************************************************************
-// Display a character on the NOKIA 1100 LCD screen at the current location
-//  c: character code
-void print_char(unsigned char c)
+// Marks a range of columns of a bank as changed in the video buffer
+//  x1, x2: 0..95  first and last column (x1 <= x2)
+//  bank: 0..8
+void lcd_mark(unsigned char x1, unsigned char x2, unsigned char bank)
 {
-    for (unsigned char i = 0; i < 5; i++)
+    if (lcd_dirty_x1[bank] == LCD_CLEAN)
     {
-        lcd_write(DATA, lcd_Font[c - 0x20][i]);
+        lcd_dirty_x1[bank] = x1;
+        lcd_dirty_x2[bank] = x2;
+        return;
     }
-    lcd_write(DATA, 0x00);
-}
 
-// Display a string of characters on the Nokia 1100 LCD screen at its current location, if the line exists
-// behind the screen in the current line, the remainder is transferred to the next line.
-//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
-void lcd_print(char *message)
-{
-    while (*message)
-        print_char(*message++); // The end of the line is indicated by zero
+    if (x1 < lcd_dirty_x1[bank])
+        lcd_dirty_x1[bank] = x1;
+    if (x2 > lcd_dirty_x2[bank])
+        lcd_dirty_x2[bank] = x2;
 }
 
 //******************************************************************************
-// Line output to the Nokia 1100 LCD screen
-//  x1, x2: 0..95  horizontal coordinate (counting from the upper left corner)
-//	y1, y2: 0..64  vertical coordinate
-//	pixel_mode: 0  - to enable the pixel
-//				1 - tu turn off the pixel
-//				2 - to invert a pixel
-void lcd_line(unsigned char x1, unsigned char y1, unsigned char x2, unsigned char y2, unsigned char pixel_mode)
+// Sends the changed ranges of the video buffer to the controller, with at most one address setting
+// per bank. The controller jumps to the next bank after column 95, so a range that continues the
+// previous one needs no address at all: a full screen is one burst of 864 bytes. Only the banks of
+// the window are sent (see lcd_window())
+void lcd_flush(void)
 {
-    int dy, dx;
-    signed char addx = 1, addy = 1;
-    signed int P, diff;
+    unsigned char bank;
 
-    unsigned char i = 0;
+    LCD_STAT_BEGIN(LCD_STAT_FLUSH);
+    lcd_bus_start();
+    for (bank = lcd_win1; bank <= lcd_win2; bank++)
+        lcd_flush_bank(bank);
+    lcd_bus_stop();
+    LCD_STAT_END();
+}
 
-    dx = abs((signed char)(x2 - x1));
-    dy = abs((signed char)(y2 - y1));
+//******************************************************************************
+// Sends the changed range of one bank inside a burst
+//  bank: 0..8
+void lcd_flush_bank(unsigned char bank)
+{
+    unsigned char x = lcd_dirty_x1[bank];
 
-    if (x1 > x2)
-        addx = -1;
-    if (y1 > y2)
-        addy = -1;
+    if (x == LCD_CLEAN)
+        return;
 
-    if (dx >= dy)
-    {
-        dy *= 2;
-        P = dy - dx;
+    lcd_address(x, bank);
+    for (; x <= lcd_dirty_x2[bank]; x++)
+        lcd_bus_frame(DATA, lcd_memory[x][bank]);
 
-        diff = P - dx;
+    lcd_dirty_x1[bank] = LCD_CLEAN;
+}
 
-        for (; i <= dx; ++i)
+//******************************************************************************
+// Sends the changes of every panel in one burst, bank by bank: bank 0 of each panel, then bank 1...
+// so all the panels are updated together. The bus is only handed from one panel to the next, only
+// panels with changes are selected, and the selected panel stays the same
+void lcd_flush_all(void)
+{
+#if LCD_PANELS > 1
+    unsigned char selected = lcd_panel, sending = LCD_PANELS, panel, bank;
+
+    LCD_STAT_BEGIN(LCD_STAT_FLUSH);
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        for (panel = 0; panel < LCD_PANELS; panel++)
         {
-            lcd_pixel(x1, y1, pixel_mode);
+            if (lcd_panels[panel].dirty_x1[bank] == LCD_CLEAN || bank < lcd_panels[panel].win1 ||
+                bank > lcd_panels[panel].win2)
+                continue;
 
-            if (P < 0)
-            {
-                P += dy;
-                x1 += addx;
-            }
-            else
-            {
-                P += diff;
-                x1 += addx;
-                y1 += addy;
+            if (sending == LCD_PANELS)
+            { // First range: start of the burst
+                lcd_select(panel);
+                lcd_bus_start();
             }
+            else if (panel != sending)
+                lcd_bus_select(panel);
+            sending = panel;
+
+            lcd_flush_bank(bank);
+        }
+
+    if (sending != LCD_PANELS)
+        lcd_bus_stop();
+    lcd_select(selected);
+    LCD_STAT_END();
+#else
+    lcd_flush();
+#endif
+}
+
+#ifdef LCD_STATS
+//******************************************************************************
+// Sets the counters of every primitive to zero, e.g. before drawing the screen to be measured
+void lcd_stats_clear(void)
+{
+    memset(lcd_stats, 0, sizeof(lcd_stats));
+}
+
+//******************************************************************************
+// Start of a primitive: the frames and bytes up to lcd_stat_end() are charged to it. A primitive
+// called by another one is part of the outer one and is not counted
+//  kind: LCD_STAT_PIXEL..LCD_STAT_FLUSH
+void lcd_stat_begin(unsigned char kind)
+{
+    if (lcd_stat_depth++)
+        return;
+
+    lcd_stat_kind = kind;
+    lcd_stats[kind].calls++;
+}
+
+//******************************************************************************
+// End of a primitive started with lcd_stat_begin()
+void lcd_stat_end(void)
+{
+    if (!--lcd_stat_depth)
+        lcd_stat_kind = LCD_STAT_OTHER;
+}
+#endif
+
+#ifdef LCD_DOUBLE_BUFFER
+//******************************************************************************
+// Shows the frame drawn in the video buffer. The whole frame is copied to the front buffer and sent
+// in the background, so drawing of the next frame can start right away and the screen never shows a
+// half drawn frame. Waits only if the previous frame is still being sent
+void lcd_swap(void)
+{
+    unsigned char bank, x;
+
+    while (lcd_async_busy)
+        ;
+
+    memcpy(lcd_front, lcd_memory, sizeof(lcd_memory));
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        lcd_dirty_x1[bank] = LCD_CLEAN; // The whole frame is on its way
+
+    lcd_bus_start();
+    lcd_address(0, 0); // After the 864 bytes the pointer is back at X = 0, Y = 0
+
+    lcd_async_x = 0;
+    lcd_async_bank = 0;
+
+#if LCD_TRANSPORT == LCD_MSSP
+    lcd_async_busy = 1;
+    clear_interrupt(INT_SSP);
+    enable_interrupts(INT_SSP);
+    lcd_ssp_isr(); // Sends the first byte, the interrupt of its end sends the next one
+#else
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        for (x = 0; x < lcd_X_RES; x++)
+            lcd_bus_frame(DATA, lcd_front[x][bank]);
+    lcd_bus_stop();
+#endif
+}
+
+//******************************************************************************
+// Returns 1 while the last frame given to lcd_swap() is being sent
+int1 lcd_busy(void)
+{
+    return lcd_async_busy;
+}
+
+#if LCD_TRANSPORT == LCD_MSSP
+//******************************************************************************
+// End of an MSSP byte: writes the next byte of the front buffer stream. The 9-bit frames are packed
+// like in lcd_bus_frame(), one output byte per interrupt
+#int_ssp
+void lcd_ssp_isr(void)
+{
+    unsigned char d;
+
+    if (lcd_spi_bits == 8)
+    { // The extra bits of the last 8 frames make up a whole byte
+        lcd_SSPBUF = lcd_spi_acc;
+        lcd_spi_acc = 0;
+        lcd_spi_bits = 0;
+    }
+    else if (lcd_async_bank < lcd_BANKS)
+    {
+        d = lcd_front[lcd_async_x][lcd_async_bank];
+        if (++lcd_async_x == lcd_X_RES)
+        {
+            lcd_async_x = 0;
+            lcd_async_bank++;
         }
+
+        lcd_spi_acc |= 0x80 >> lcd_spi_bits; // DATA bit
+        if (lcd_spi_bits < 7)
+            lcd_spi_acc |= d >> (lcd_spi_bits + 1);
+        lcd_SSPBUF = lcd_spi_acc;
+        lcd_spi_acc = d << (7 - lcd_spi_bits); // The low bits of d wait for the next byte
+        lcd_spi_bits++;
+    }
+    else if (lcd_spi_bits)
+    { // Zeros complete the last byte, the unfinished frame is discarded when CS goes high
+        lcd_SSPBUF = lcd_spi_acc;
+        lcd_spi_acc = 0;
+        lcd_spi_bits = 0;
+    }
+    else
+    { // Frame complete
+        disable_interrupts(INT_SSP);
+        output_high(LCD_CS);
+        lcd_async_busy = 0;
+    }
+}
+#endif
+#endif
+
+//******************************************************************************
+// Sets the cursor to the desired position. The countdown begins in the
+// upper left corner. Horizontal 16 familiarity, vertical - 8
+//  x: 0..15  (larger values are taken as 15)
+//  y: 0..8  (larger values are taken as 8)
+void gotoxy(char x, char y)
+{
+    if (x > 15)
+        x = 15;
+    if (y >= lcd_BANKS)
+        y = lcd_BANKS - 1;
+    x = x * 6; // We pass from the coordinate in familiarity to the coordinates in pixels
+
+    lcd_xcurr = x;
+    lcd_ycurr = y;
+
+    if (lcd_deferred)
+        return;
+
+    lcd_bus_start();
+    lcd_address(x, y);
+    lcd_bus_stop();
+}
+
+//******************************************************************************
+// Set the inversion mode of the entire screen. Data on the screen does not change, only inverted
+//  mode: INV_MODE_ON or INV_MODE_OFF
+void lcd_inverse(unsigned char mode)
+{
+    if (mode)
+        lcd_write(CMD, 0xA6);
+    else
+        lcd_write(CMD, 0xA7);
+}
+
+//******************************************************************************
+// Sets the cursor in pixels. The countdown begins in the upper
+// left corner. 96 pixels horizontally, 65 pixels vertically
+//  x: 0..95  (larger values are taken as 95)
+//  y: 0..67  (larger values are taken as the last bank)
+void lcd_gotoxy_pix(char x, char y)
+{
+    lcd_xcurr = (x < lcd_X_RES) ? x : lcd_X_RES - 1;
+    lcd_ycurr = (y < lcd_Y_RES) ? y / 8 : lcd_BANKS - 1;
+
+    if (lcd_deferred)
+        return;
+
+    lcd_bus_start();
+    lcd_address(lcd_xcurr, lcd_ycurr);
+    lcd_bus_stop();
+}
+
+//******************************************************************************
+// Conclusion of a point on the Nokia 1100 LCD screen. Points out of the screen are not drawn
+//  x: 0..95  horizontal coordinate (counting from the upper left corner)
+//	y: 0..67  vertical coordinate
+//	pixel_mode: PIXEL_ON  - to enable pixel
+//				PIXEL_OFF - to turn off the pixel
+//				PIXEL_INV - to invert a pixel
+void lcd_pixel(signed int16 x, signed int16 y, unsigned char pixel_mode)
+{
+    if (x < 0 || x >= lcd_X_RES || y < 0 || y >= lcd_Y_RES)
+        return;
+
+    LCD_STAT_BEGIN(LCD_STAT_PIXEL);
+    lcd_plot(x, y, pixel_mode);
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Point of a primitive already clipped to the screen, without checking the coordinates
+//  x: 0..95  horizontal coordinate
+//	y: 0..67  vertical coordinate
+//	pixel_mode: PIXEL_ON, PIXEL_OFF or PIXEL_INV
+void lcd_plot(unsigned char x, unsigned char y, unsigned char pixel_mode)
+{
+    lcd_rop(x, x, y / 8, 1 << (y % 8), pixel_mode);
+}
+
+//******************************************************************************
+// Start of a run of consecutive bytes in one bank, written with lcd_run_put(). In direct mode the
+// controller pointer is set once and every byte goes out right after the previous one
+//  x: 0..95  first column
+//  bank: 0..8
+void lcd_run_start(unsigned char x, unsigned char bank)
+{
+    lcd_run_x = x;
+    lcd_run_bank = bank;
+
+    if (!lcd_deferred)
+        lcd_gotoxy_pix(x, bank * 8);
+}
+
+//******************************************************************************
+// Next byte of a run: stored in the video buffer and sent to the controller, or marked for lcd_flush()
+//  c: new value of the byte
+void lcd_run_put(unsigned char c)
+{
+    if (lcd_deferred)
+    {
+#ifdef LCD_SKIP_UNCHANGED
+        if (lcd_memory[lcd_run_x][lcd_run_bank] != c)
+#endif
+            lcd_mark(lcd_run_x, lcd_run_x, lcd_run_bank);
+        lcd_memory[lcd_run_x][lcd_run_bank] = c;
+        LCD_STAT_BYTES(1);
     }
     else
     {
-        dx *= 2;
-        P = dx - dy;
-        diff = P - dy;
+        lcd_write(DATA, c); // The cursor of the video buffer is at the same place
+    }
+    lcd_run_x++;
+}
+
+//******************************************************************************
+// Writes the part of a line of text that falls in one bank. The 7 rows of each font column are
+// shifted into place and merged with the rest of the byte by lcd_rop(), so every column is a single
+// byte. Columns left of the screen are skipped
+//  x: horizontal coordinate of the first character, may be negative
+//  bank: 0..8
+//  message: text, 0x00 - a sign of the end of the line
+//  shift: 0..7  row of the bank where the characters begin (y % 8)
+//  next: 0 - bank of the top of the characters, 1 - following bank, with the rows shifted out of it
+//  width: 5 - only the characters, 6 - with the empty column after each one
+void lcd_text_run(signed int16 x, unsigned char bank, char *message, unsigned char shift, int1 next, unsigned char width)
+{
+    unsigned char g, j, bits, mask;
+    signed int16 x1 = (x < 0) ? 0 : x;
+
+    if (next)
+        mask = 0x7F >> (8 - shift);
+    else
+        mask = 0x7F << shift;
 
-        for (; i <= dy; ++i)
+    for (; *message && x < lcd_X_RES; message++) // The rest of the text may be out of the screen
+    {
+        if (x + width <= 0)
+        { // Character left of the screen
+            x += width;
+            continue;
+        }
+        g = lcd_char_index(*message);
+
+        for (j = 0; j < width && x < lcd_X_RES; j++, x++)
         {
-            lcd_pixel(x1, y1, pixel_mode);
+            if (x < 0)
+                continue;
+#ifdef LCD_FONT_SHIFTED
+            bits = (j < 5 && g != LCD_NO_CHAR) ? lcd_FontShift[g][LCD_FONT_SHIFT_AT(shift, next) + j] : 0x00;
+#else
+            bits = lcd_char_column(g, j);
+            if (next)
+                bits >>= 8 - shift;
+            else
+                bits <<= shift;
+#endif
 
-            if (P < 0)
-            {
-                P += dx;
-                y1 += addy;
-            }
+            lcd_rop_src[x] = bits;
+        }
+    }
+
+    if (x > x1)
+        lcd_rop(x1, x - 1, bank, mask, PIXEL_COPY | LCD_ROP_BITS);
+}
+
+//******************************************************************************
+// Display a character on the NOKIA 1100 LCD screen at the specified coordinates in pixels
+//  c: character code
+//  x: 0..95  horizontal coordinate (counting from the upper left corner)
+//	y: 0..64  vertical coordinate, nothing is drawn from lcd_Y_RES on
+void pix_char(unsigned char x, unsigned char y, unsigned char c)
+{
+    char message[2];
+
+    message[0] = c;
+    message[1] = 0x00;
+
+    lcd_text(x, y, message, 5);
+}
+
+//******************************************************************************
+// Display a string of characters on the NOKIA 1100 LCD screen at the specified coordinates in pixels,
+// with an empty column after each character like lcd_print(). Characters out of the screen are not drawn
+//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
+//  x: 0..95  horizontal coordinate (counting from the upper left corner)
+//	y: 0..64  vertical coordinate, nothing is drawn from lcd_Y_RES on
+void pix_print(unsigned char x, unsigned char y, char *message)
+{
+    lcd_text(x, y, message, 6);
+}
+
+//******************************************************************************
+// Writes a line of text at any pixel, clipped to the screen on every side like the other primitives:
+// the rows above and below the screen and the columns left and right of it are not drawn
+//  x, y: upper left corner of the first character, may be out of the screen
+//  message: text, 0x00 - a sign of the end of the line
+//  width: 5 - a single character (pix_char()), 6 - with the empty column after each one
+void lcd_text(signed int16 x, signed int16 y, char *message, unsigned char width)
+{
+    if (y >= lcd_Y_RES || y <= -7 || x >= lcd_X_RES)
+        return; // Nothing on the screen, the banks would be out of the video buffer
+
+    LCD_STAT_BEGIN(LCD_STAT_TEXT);
+    if (y >= 0)
+    {
+        lcd_text_run(x, y / 8, message, y % 8, 0, width);
+        if (y % 8 > 1 && y / 8 + 1 < lcd_BANKS) // From row 2 of the bank on the character goes on in the next one
+            lcd_text_run(x, y / 8 + 1, message, y % 8, 1, width);
+    }
+    else // Only the rows that go on in bank 0
+        lcd_text_run(x, 0, message, y + 8, 1, width);
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Display a character on the NOKIA 1100 LCD screen at the current location
+//  c: character code
+void print_char(unsigned char c)
+{
+    LCD_STAT_BEGIN(LCD_STAT_TEXT);
+    c = lcd_char_index(c);
+
+    for (unsigned char i = 0; i < 5; i++)
+    {
+        lcd_write(DATA, lcd_char_column(c, i));
+    }
+    lcd_write(DATA, 0x00);
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Position of a character in the font table
+//  c: character code
+//  returns LCD_NO_CHAR for the characters out of the font (or of the subset made by tools/fontgen.c)
+unsigned char lcd_char_index(unsigned char c)
+{
+    if (c < 0x20 || c > 0x7F)
+        return LCD_NO_CHAR;
+#ifdef LCD_FONT_SUBSET
+    return lcd_FontIndex[c - 0x20];
+#else
+    return c - 0x20;
+#endif
+}
+
+//******************************************************************************
+// Column of a character at row 0 of a bank
+//  g: position in the font table, from lcd_char_index()
+//  j: column, 0..4 (5 and more are the empty space after the character)
+unsigned char lcd_char_column(unsigned char g, unsigned char j)
+{
+    if (j >= 5 || g == LCD_NO_CHAR)
+        return 0x00;
+#ifdef LCD_FONT_SHIFTED
+    return lcd_FontShift[g][j];
+#elif defined(LCD_NO_FIXED_FONT)
+    return lcd_font_cell(g + 0x20, j);
+#else
+    return lcd_Font[g][j];
+#endif
+}
+
+// Display a string of characters on the Nokia 1100 LCD screen at its current location, if the line exists
+// behind the screen in the current line, the remainder is transferred to the next line.
+//  message: pointer to a string of characters. 0x00 - a sign of the end of the line.
+void lcd_print(char *message)
+{
+    while (*message)
+        print_char(*message++); // The end of the line is indicated by zero
+}
+
+//******************************************************************************
+// Combines source pixels with a byte of the video buffer
+//  old: current byte
+//  bits: source pixels
+//  area: pixels of the byte covered by the source, the others are left as they are
+//	pixel_mode: PIXEL_ON, PIXEL_OFF, PIXEL_INV, PIXEL_COPY or PIXEL_AND
+unsigned char lcd_combine(unsigned char old, unsigned char bits, unsigned char area, unsigned char pixel_mode)
+{
+    bits &= area;
+
+    switch (pixel_mode)
+    {
+    case PIXEL_ON:
+        return old | bits;
+    case PIXEL_OFF:
+        return old & ~bits;
+    case PIXEL_INV:
+        return old ^ bits;
+    case PIXEL_COPY:
+        return (old & ~area) | bits;
+    case PIXEL_AND:
+        return old & (bits | ~area);
+    }
+    return old;
+}
+
+//******************************************************************************
+// Mask of the pixels of a bank that lie between two rows
+//  bank: 0..8
+//  y1, y2: 0..67  first and last row (y1 <= y2)
+unsigned char lcd_bank_mask(unsigned char bank, unsigned char y1, unsigned char y2)
+{
+    unsigned char mask = 0xFF;
+
+    if (bank == y1 / 8)
+        mask &= 0xFF << (y1 % 8); // Head: rows above y1 are left as they are
+    if (bank == y2 / 8)
+        mask &= 0xFF >> (7 - y2 % 8); // Tail: rows below y2 as well
+
+    return mask;
+}
+
+//******************************************************************************
+// Raster-op kernel: applies a pixel mode to the pixels of a mask in a range of columns of one bank, a
+// whole byte (8 rows) at a time and with one address setting per run of bytes. Every primitive draws
+// through it. The source pixels are all on, or those of lcd_rop_src[] (LCD_ROP_BITS), and with
+// PIXEL_PATTERN only those of the shade. The columns where PIXEL_ON, PIXEL_OFF or PIXEL_INV would not
+// change anything are skipped
+//  x1, x2: 0..95  first and last column (x1 <= x2)
+//  bank: 0..8
+//  mask: pixels of each byte affected, and with LCD_ROP_AREA only those set in lcd_rop_src[]
+//	op: PIXEL_ON, PIXEL_OFF, PIXEL_INV, PIXEL_COPY or PIXEL_AND, with PIXEL_PATTERN, LCD_ROP_AREA or
+//      LCD_ROP_BITS ORed
+void lcd_rop(unsigned char x1, unsigned char x2, unsigned char bank, unsigned char mask, unsigned char op)
+{
+    unsigned char mode = op & LCD_ROP_MODE, area, bits;
+    int1 run = 0;
+
+    for (; x1 <= x2; x1++)
+    {
+        area = mask;
+        bits = 0xFF;
+        if (op & LCD_ROP_AREA)
+            area &= lcd_rop_src[x1];
+        if (op & LCD_ROP_BITS)
+            bits = lcd_rop_src[x1];
+        if (op & PIXEL_PATTERN)
+            bits &= lcd_shade[x1 & 3];
+
+        if (!area || (mode <= PIXEL_INV && !(bits & area)))
+        { // Nothing changes in this column
+            run = 0;
+            continue;
+        }
+
+        if (!run)
+            lcd_run_start(x1, bank);
+        lcd_run_put(lcd_combine(lcd_memory[x1][bank], bits, area, mode));
+        run = 1;
+    }
+}
+
+//******************************************************************************
+// Sets the shade of the drawings made with PIXEL_PATTERN: an ordered 4 x 4 dither that gives grey
+// levels, fixed to the screen so shapes drawn next to each other join without seams
+//  level: 0..16  pixels on out of every 16, 16 - all on (solid)
+void lcd_set_shade(unsigned char level)
+{
+    unsigned char col, row, bits;
+
+    for (col = 0; col < 4; col++)
+    {
+        bits = 0;
+        for (row = 0; row < 4; row++)
+            if (lcd_bayer[row][col] < level)
+                bits |= 1 << row;
+        lcd_shade[col] = bits | (bits << 4); // Rows 4..7 repeat rows 0..3
+    }
+}
+
+//******************************************************************************
+// Horizontal line output to the Nokia 1100 LCD screen. The part out of the screen is not drawn
+//  x1, x2: horizontal coordinates of the ends, may be out of the screen
+//	y: vertical coordinate
+//	pixel_mode: PIXEL_ON, PIXEL_OFF or PIXEL_INV
+void lcd_hline(signed int16 x1, signed int16 x2, signed int16 y, unsigned char pixel_mode)
+{
+    signed int16 temp;
+
+    if (x1 > x2)
+    {
+        temp = x1;
+        x1 = x2;
+        x2 = temp;
+    }
+
+    if (y < 0 || y >= lcd_Y_RES || x2 < 0 || x1 >= lcd_X_RES)
+        return;
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 >= lcd_X_RES)
+        x2 = lcd_X_RES - 1;
+
+    LCD_STAT_BEGIN(LCD_STAT_LINE);
+    lcd_rop(x1, x2, y / 8, 1 << (y % 8), pixel_mode);
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Vertical line output to the Nokia 1100 LCD screen, one byte per bank. The part out of the screen
+// is not drawn
+//  x: horizontal coordinate
+//	y1, y2: vertical coordinates of the ends, may be out of the screen
+//	pixel_mode: PIXEL_ON, PIXEL_OFF or PIXEL_INV
+void lcd_vline(signed int16 x, signed int16 y1, signed int16 y2, unsigned char pixel_mode)
+{
+    signed int16 temp;
+    unsigned char bank;
+
+    if (y1 > y2)
+    {
+        temp = y1;
+        y1 = y2;
+        y2 = temp;
+    }
+
+    if (x < 0 || x >= lcd_X_RES || y2 < 0 || y1 >= lcd_Y_RES)
+        return;
+    if (y1 < 0)
+        y1 = 0;
+    if (y2 >= lcd_Y_RES)
+        y2 = lcd_Y_RES - 1;
+
+    LCD_STAT_BEGIN(LCD_STAT_LINE);
+    for (bank = y1 / 8; bank <= y2 / 8; bank++)
+        lcd_rop(x, x, bank, lcd_bank_mask(bank, y1, y2), pixel_mode);
+    LCD_STAT_END();
+}
+
+//******************************************************************************
+// Sides of the screen a point lies beyond
+//  x, y: coordinates of the point
+unsigned char lcd_outcode(signed int16 x, signed int16 y)
+{
+    unsigned char code = 0;
+
+    if (x < 0)
+        code |= LCD_CLIP_LEFT;
+    else if (x >= lcd_X_RES)
+        code |= LCD_CLIP_RIGHT;
+    if (y < 0)
+        code |= LCD_CLIP_TOP;
+    else if (y >= lcd_Y_RES)
+        code |= LCD_CLIP_BOTTOM;
+
+    return code;
+}
+
+//******************************************************************************
+// Line output to the Nokia 1100 LCD screen. Lines with both ends beyond the same side of the screen
+// are rejected by their outcodes; for the others the range of Bresenham steps that fall on the screen
+// is worked out once, so the loop draws only those, without checks, and the pixels are the same as
+// for the whole line
+//  x1, x2: horizontal coordinate (counting from the upper left corner), -8192..8191
+//	y1, y2: vertical coordinate, -8192..8191
+//	pixel_mode: 0  - to enable the pixel
+//				1 - tu turn off the pixel
+//				2 - to invert a pixel
+void lcd_line(signed int16 x1, signed int16 y1, signed int16 x2, signed int16 y2, unsigned char pixel_mode)
+{
+    signed int16 u, v, du, dv, first, last, kmin, kmax, P;
+    signed int32 t;
+    signed char su = 1, sv = 1;
+    unsigned char umax, vmax, x, y, n, nx, ny, xa;
+    int1 steep;
+
+    if (y1 == y2)
+    { // Horizontal and vertical lines are drawn a whole byte at a time
+        lcd_hline(x1, x2, y1, pixel_mode);
+        return;
+    }
+    if (x1 == x2)
+    {
+        lcd_vline(x1, y1, y2, pixel_mode);
+        return;
+    }
+
+    if (lcd_outcode(x1, y1) & lcd_outcode(x2, y2))
+        return; // Both ends beyond the same side
+
+    // u: axis along which the line advances one pixel per step, v: the other one
+    u = x2 - x1;
+    v = y2 - y1;
+    steep = ((v < 0) ? -v : v) > ((u < 0) ? -u : u);
+    if (steep)
+    {
+        u = y1;
+        du = y2 - y1;
+        umax = lcd_Y_RES - 1;
+        v = x1;
+        dv = x2 - x1;
+        vmax = lcd_X_RES - 1;
+    }
+    else
+    {
+        u = x1;
+        du = x2 - x1;
+        umax = lcd_X_RES - 1;
+        v = y1;
+        dv = y2 - y1;
+        vmax = lcd_Y_RES - 1;
+    }
+    if (du < 0)
+    {
+        du = -du;
+        su = -1;
+    }
+    if (dv < 0)
+    {
+        dv = -dv;
+        sv = -1;
+    }
+
+    // Step i (0..du) is at u + su * i, v + sv * k with k = (2 * dv * i + du) / (2 * du).
+    // Steps whose u is on the screen
+    first = (su > 0) ? -u : u - umax;
+    last = (su > 0) ? umax - u : u;
+
+    // Steps whose k keeps v on the screen
+    kmin = (sv > 0) ? -v : v - vmax;
+    kmax = (sv > 0) ? vmax - v : v;
+    if (kmax < 0)
+        return;
+    if (kmin > 0)
+    {
+        t = ((signed int32)2 * du * kmin - du + 2 * dv - 1) / (2 * dv);
+        if (t > du)
+            return; // v only reaches the screen after the end of the line
+        if (t > first)
+            first = t;
+    }
+    t = ((signed int32)2 * du * (kmax + 1) - du - 1) / (2 * dv);
+    if (t < last)
+        last = t;
+
+    if (first < 0)
+        first = 0;
+    if (last > du)
+        last = du;
+    if (first > last)
+        return; // The line passes by the screen
+
+    // State of the Bresenham loop at the first step drawn
+    kmin = ((signed int32)2 * dv * first + du) / (2 * du);
+    P = 2 * dv - du + (signed int32)2 * dv * first - (signed int32)2 * du * kmin;
+    u += su * first;
+    v += sv * kmin;
+    x = steep ? v : u;
+    y = steep ? u : v;
+
+    // The pixels are gathered in lcd_rop_src[], one byte per column, and each run of columns in one
+    // bank goes to lcd_rop() at once: up to 8 pixels of a steep line share a byte
+    LCD_STAT_BEGIN(LCD_STAT_LINE);
+    xa = x;
+    lcd_rop_src[x] = 0;
+    for (n = last - first;; n--)
+    {
+        lcd_rop_src[x] |= 1 << (y % 8);
+        if (!n)
+            break;
+
+        nx = x;
+        ny = y;
+        if (steep)
+            ny += su;
+        else
+            nx += su;
+        if (P >= 0)
+        {
+            if (steep)
+                nx += sv;
             else
-            {
-                P += diff;
-                x1 += addx;
-                y1 += addy;
-            }
+                ny += sv;
+            P -= 2 * du;
+        }
+        P += 2 * dv;
+
+        if (ny / 8 != y / 8)
+        { // Next bank: the run so far is drawn
+            lcd_rop((xa < x) ? xa : x, (xa < x) ? x : xa, y / 8, 0xFF, pixel_mode | LCD_ROP_AREA);
+            xa = nx;
+            lcd_rop_src[nx] = 0;
         }
+        else if (nx != x)
+            lcd_rop_src[nx] = 0;
+        x = nx;
+        y = ny;
     }
+    lcd_rop((xa < x) ? xa : x, (xa < x) ? x : xa, y / 8, 0xFF, pixel_mode | LCD_ROP_AREA);
+    LCD_STAT_END();
 }
 
 //******************************************************************************
-// Display the circle on the Nokia 1100 LCD screen
-//  x: 0..95  coordinate of the circle (counting from the upper left corner)
-//	y: 0..64  vertical coordinate
-//  radius:   circle radius
-//  fill:		FILL_OFF  - no fill circle
+// Border test of lcd_arc(): dx^2 a + dy^2 b - max(dx a, dy b) < c. With a = b = 1 and c = r^2 the
+// pixels inside are those of the midpoint circle; the max() term moves the border half a pixel out
+// along the axis that changes more slowly, so ellipses get the same shape
+//  dx, dy: distance of the pixel from the center
+//  a, b, c: ry^2, rx^2 and rx^2 ry^2 of the ellipse
+int1 lcd_arc_inside(unsigned int16 dx, unsigned int16 dy, unsigned int32 a, unsigned int32 b, unsigned int32 c)
+{
+    unsigned int32 u, v;
+
+    u = dx * a;
+    v = dy * b;
+    return u * dx + v * dy - ((u > v) ? u : v) < c; // Never negative: dx (dx - 1) a >= 0
+}
+
+//******************************************************************************
+// Display quadrants of an ellipse on the Nokia 1100 LCD screen. The half width of every row is found
+// once, walking from the center out, and the shape is then written bank by bank: every byte gets the
+// pixels of its 8 rows at once and only once, so PIXEL_INV inverts each pixel of the outline or the
+// fill exactly one time. The parts out of the screen are skipped
+//  x: coordinate of the center (counting from the upper left corner)
+//	y: vertical coordinate
+//  rx, ry: horizontal and vertical radius, 0..127 when they differ (reduced to LCD_ELLIPSE_MAX)
+//  quadrants: ARC_TOP_RIGHT, ARC_TOP_LEFT, ARC_BOTTOM_LEFT, ARC_BOTTOM_RIGHT or any of them ORed,
+//             ARC_ALL for the whole ellipse. Filled quadrants are quarters of the disc
+//  fill:		FILL_OFF  - only the outline
 //				FILL_ON	  - with fill
 //	pixel_mode: PIXEL_ON  - to enable the pixel
 //				PIXEL_OFF - to turn off the pixel
 //				PIXEL_INV - to invert a pixel
-void lcd_circle(unsigned char x, unsigned char y, unsigned char radius, unsigned char fill, int pixel_mode)
+void lcd_arc(signed int16 x, signed int16 y, unsigned char rx, unsigned char ry, unsigned char quadrants, unsigned char fill, unsigned char pixel_mode)
 {
-    signed char a, b, P;
+    unsigned int32 a, b, c;
+    signed int16 h, dy, row, col, d, x1, x2, hmax, lmin;
+    signed int16 hi[8], lo[8];
+    unsigned char sides[8], bank, bank2, k, mask, side;
 
-    a = 0;
-    b = radius;
-    P = 1 - radius;
+    if (rx != ry)
+    {
+        if (rx > LCD_ELLIPSE_MAX)
+            rx = LCD_ELLIPSE_MAX;
+        if (ry > LCD_ELLIPSE_MAX)
+            ry = LCD_ELLIPSE_MAX;
+    }
 
-    do
+    if (!(quadrants & ARC_ALL) || x + rx < 0 || x - rx >= lcd_X_RES || y + ry < 0 || y - ry >= lcd_Y_RES)
+        return; // Nothing to draw or out of the screen
+
+    LCD_STAT_BEGIN(LCD_STAT_ARC);
+    if (rx == ry)
+    { // Circle
+        a = 1;
+        b = 1;
+        c = (unsigned int32)rx * rx;
+    }
+    else if (!rx || !ry)
+    { // Straight line: every pixel of the box
+        a = 0;
+        b = 0;
+        c = 1;
+    }
+    else
+    {
+        a = (unsigned int32)ry * ry;
+        b = (unsigned int32)rx * rx;
+        c = a * b;
+    }
+
+    // Half widths of the rows on the screen and the ones just above and below it. They only get
+    // smaller going away from the center, so each row goes on from the width of the previous one
+    for (row = 0; row < lcd_Y_RES + 2; row++)
+        lcd_arc_w[row] = -1;
+    h = rx;
+    for (dy = 0; dy <= ry; dy++)
     {
-        if (fill)
+        while (h > 0 && !lcd_arc_inside(h, dy, a, b, c))
+            h--;
+        if (y - dy >= -1 && y - dy <= lcd_Y_RES)
+            lcd_arc_w[y - dy + 1] = h;
+        if (y + dy >= -1 && y + dy <= lcd_Y_RES)
+            lcd_arc_w[y + dy + 1] = h;
+    }
+
+    bank = (y - ry < 0) ? 0 : (y - ry) / 8;
+    bank2 = (y + ry >= lcd_Y_RES) ? (lcd_Y_RES - 1) / 8 : (y + ry) / 8;
+
+    for (; bank <= bank2; bank++)
+    {
+        // Columns of each row of the bank, as distances from the center: the whole row for fills,
+        // for outlines only the part past the end of the next row away from the center (at least
+        // the last pixel). Plus the quadrants the row belongs to
+        hmax = -1;
+        lmin = 255;
+        for (k = 0; k < 8; k++)
         {
-            lcd_line(x - a, y + b, x + a, y + b, pixel_mode);
-            lcd_line(x - a, y - b, x + a, y - b, pixel_mode);
-            lcd_line(x - b, y + a, x + b, y + a, pixel_mode);
-            lcd_line(x - b, y - a, x + b, y - a, pixel_mode);
+            row = bank * 8 + k;
+            hi[k] = (row < lcd_Y_RES) ? lcd_arc_w[row + 1] : -1;
+            lo[k] = 0;
+            if (!fill && hi[k] >= 0)
+            {
+                d = lcd_arc_w[(row < y) ? row : row + 2] + 1;
+                lo[k] = (d < hi[k]) ? d : hi[k];
+            }
+            sides[k] = (row < y) ? ARC_TOP : ((row > y) ? ARC_BOTTOM : ARC_ALL);
+
+            if (hi[k] < 0)
+                continue;
+            if (hi[k] > hmax)
+                hmax = hi[k];
+            if (lo[k] < lmin)
+                lmin = lo[k];
         }
-        else
+        if (hmax < 0)
+            continue;
+
+        x1 = (x - hmax < 0) ? 0 : x - hmax;
+        x2 = (x + hmax >= lcd_X_RES) ? lcd_X_RES - 1 : x + hmax;
+        if (x1 > x2)
+            continue; // The rows of this bank end before the screen (center out of it)
+
+        // Pixels of every column of the bank, then drawn by lcd_rop(), which skips the empty ones
+        for (col = x1; col <= x2; col++)
         {
-            lcd_pixel(a + x, b + y, pixel_mode);
-            lcd_pixel(b + x, a + y, pixel_mode);
-            lcd_pixel(x - a, b + y, pixel_mode);
-            lcd_pixel(x - b, a + y, pixel_mode);
-            lcd_pixel(b + x, y - a, pixel_mode);
-            lcd_pixel(a + x, y - b, pixel_mode);
-            lcd_pixel(x - a, y - b, pixel_mode);
-            lcd_pixel(x - b, y - a, pixel_mode);
+            mask = 0;
+            d = (col < x) ? x - col : col - x;
+            if (d >= lmin) // Else in the hole of the outline
+            {
+                side = quadrants & ((col < x) ? ARC_LEFT : ((col > x) ? ARC_RIGHT : ARC_ALL));
+                for (k = 0; k < 8; k++)
+                    if (d >= lo[k] && d <= hi[k] && (sides[k] & side))
+                        mask |= 1 << k;
+            }
+            lcd_rop_src[col] = mask;
         }
+        lcd_rop(x1, x2, bank, 0xFF, pixel_mode | LCD_ROP_AREA);
+    }
+    LCD_STAT_END();
+}
 
-        if (P < 0)
-            P += 3 + 2 * a++;
-        else
-            P += 5 + 2 * (a++ - b--);
-    } while (a <= b);
+//******************************************************************************
+// Display the circle on the Nokia 1100 LCD screen: the midpoint circle, with every pixel written once
+// (see lcd_arc()). The center may be out of the screen
+//  x: coordinate of the center (counting from the upper left corner)
+//	y: vertical coordinate
+//  radius:   circle radius
+//  fill:		FILL_OFF  - no fill circle
+//				FILL_ON	  - with fill
+//	pixel_mode: PIXEL_ON  - to enable the pixel
+//				PIXEL_OFF - to turn off the pixel
+//				PIXEL_INV - to invert a pixel
+void lcd_circle(signed int16 x, signed int16 y, unsigned char radius, unsigned char fill, unsigned char pixel_mode)
+{
+    lcd_arc(x, y, radius, radius, ARC_ALL, fill, pixel_mode);
+}
+
+//******************************************************************************
+// Display an ellipse with horizontal and vertical axes on the Nokia 1100 LCD screen (see lcd_arc())
+//  x: coordinate of the center (counting from the upper left corner)
+//	y: vertical coordinate
+//  rx, ry: horizontal and vertical radius, 0..127
+//  fill:		FILL_OFF  - no fill
+//				FILL_ON	  - with fill
+//	pixel_mode: PIXEL_ON, PIXEL_OFF or PIXEL_INV
+void lcd_ellipse(signed int16 x, signed int16 y, unsigned char rx, unsigned char ry, unsigned char fill, unsigned char pixel_mode)
+{
+    lcd_arc(x, y, rx, ry, ARC_ALL, fill, pixel_mode);
 }
 
 //******************************************************************************
-// Display a rectangle on the Nokia 1100 LCD screen
-//  x1, x2: 0..95  horizontal coordinate (counting from the upper left corner)
-//	y1, y2: 0..64  vertical coordinate
+// Display a rectangle on the Nokia 1100 LCD screen. The corners are sorted and clipped to the screen
+// once, then the rectangle is drawn as spans of whole bytes
+//  x1, x2: horizontal coordinate (counting from the upper left corner), may be out of the screen
+//	y1, y2: vertical coordinate
 //	pixel_mode: PIXEL_ON  - to enable the pixel
 //				PIXEL_OFF - to turn off the pixel
 //				PIXEL_INV - to invert a pixel
-void lcd_rectangle(unsigned char x1, unsigned char y1, unsigned char x2, unsigned char y2, unsigned char fill, unsigned char pixel_mode)
+void lcd_rectangle(signed int16 x1, signed int16 y1, signed int16 x2, signed int16 y2, unsigned char fill, unsigned char pixel_mode)
 {
-    if (fill)
-    { // With fill
-        unsigned char i, xmin, xmax, ymin, ymax;
+    signed int16 temp;
+    unsigned char bank;
 
-        if (x1 < x2)
-        {
-            xmin = x1;
-            xmax = x2;
-        } // Determine the minimum and maximum coordinate in X
-        else
-        {
-            xmin = x2;
-            xmax = x1;
-        }
+    if (x1 > x2)
+    { // Determine the minimum and maximum coordinate in X
+        temp = x1;
+        x1 = x2;
+        x2 = temp;
+    }
+    if (y1 > y2)
+    { // Determine the minimum and maximum coordinate in Y
+        temp = y1;
+        y1 = y2;
+        y2 = temp;
+    }
 
-        if (y1 < y2)
-        {
-            ymin = y1;
-            ymax = y2;
-        } // Determine the minimum and maximum coordinate in Y
-        else
-        {
-            ymin = y2;
-            ymax = y1;
-        }
+    if (fill)
+    { // With fill
+        if (x2 < 0 || x1 >= lcd_X_RES || y2 < 0 || y1 >= lcd_Y_RES)
+            return;
+        if (x1 < 0)
+            x1 = 0;
+        if (x2 >= lcd_X_RES)
+            x2 = lcd_X_RES - 1;
+        if (y1 < 0)
+            y1 = 0;
+        if (y2 >= lcd_Y_RES)
+            y2 = lcd_Y_RES - 1;
 
-        for (; xmin <= xmax; ++xmin)
-        {
-            for (i = ymin; i <= ymax; ++i)
-                lcd_pixel(xmin, i, pixel_mode);
-        }
+        LCD_STAT_BEGIN(LCD_STAT_RECT);
+        for (bank = y1 / 8; bank <= y2 / 8; bank++) // One span of whole bytes per bank
+            lcd_rop(x1, x2, bank, lcd_bank_mask(bank, y1, y2), pixel_mode);
+        LCD_STAT_END();
     }
     else // No fill
     {
-        lcd_line(x1, y1, x2, y1, pixel_mode); // Draw the sides of the rectangle
-        lcd_line(x1, y2, x2, y2, pixel_mode);
-        lcd_line(x1, y1 + 1, x1, y2 - 1, pixel_mode);
-        lcd_line(x2, y1 + 1, x2, y2 - 1, pixel_mode);
+        LCD_STAT_BEGIN(LCD_STAT_RECT);
+        lcd_hline(x1, x2, y1, pixel_mode); // Draw the sides of the rectangle, each side clipped on its own
+        if (y2 != y1)
+            lcd_hline(x1, x2, y2, pixel_mode);
+        if (y2 - y1 >= 2)
+        { // Between the top and bottom sides
+            lcd_vline(x1, y1 + 1, y2 - 1, pixel_mode);
+            if (x2 != x1)
+                lcd_vline(x2, y1 + 1, y2 - 1, pixel_mode);
+        }
+        LCD_STAT_END();
     }
 }
 
@@ -0,0 +1,160 @@
+//***************************************************************************
+//  File........: lcd1100_scroll.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: PIC18F45K50 (May be adapted to any PIC)
+//  Compiler....: CCS
+//  Description.: Vertical scroll through the start row of the PCF8814, horizontal scroll of
+//                bands of the video buffer and text tickers
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_lib.c
+
+#ifndef _LCD1100_SCROLL_C_
+#define _LCD1100_SCROLL_C_
+
+// Ticker: text, next character and column of it, and bank where it runs
+static char *lcd_ticker_text;
+static unsigned char lcd_ticker_char, lcd_ticker_col, lcd_ticker_bank;
+
+// Function prototypes
+void lcd_scroll_v(unsigned char row);
+void lcd_scroll_up(unsigned char rows);
+void lcd_shift_bank(unsigned char bank, signed char dx, unsigned char fill);
+void lcd_scroll_h(unsigned char bank1, unsigned char bank2, signed char dx);
+void lcd_ticker_start(unsigned char bank, char *text);
+void lcd_ticker_step(void);
+
+//******************************************************************************
+// Vertical scroll of the whole screen. Only the start row register of the controller changes, no
+// data is sent. The video buffer keeps its coordinates: row "row" of it is shown at the top
+//  row: 0..63
+void lcd_scroll_v(unsigned char row)
+{
+    lcd_start_row = row & 0x3F;
+    lcd_write(CMD, 0x40 | lcd_start_row); // Set start row: 01ss ssss
+}
+
+//******************************************************************************
+// Scrolls the screen up a number of rows from its current position
+//  rows: rows to scroll
+void lcd_scroll_up(unsigned char rows)
+{
+    lcd_scroll_v(lcd_start_row + rows);
+}
+
+//******************************************************************************
+// Shifts one bank of the video buffer horizontally. The controller cannot scroll sideways, so the
+// bytes are moved in the buffer and only the range of columns whose value changed is sent
+//  bank: 0..8  (other values are ignored)
+//  dx: columns to the left (positive) or to the right (negative)
+//  fill: value of the columns that enter the screen
+void lcd_shift_bank(unsigned char bank, signed char dx, unsigned char fill)
+{
+    unsigned char x, n, c, x1 = LCD_CLEAN, x2 = 0;
+
+    if (bank >= lcd_BANKS)
+        return;
+
+    if (dx >= 0)
+    {
+        n = dx;
+        for (x = 0; x < lcd_X_RES; x++)
+        {
+            c = (x + n < lcd_X_RES) ? lcd_memory[x + n][bank] : fill;
+            if (c != lcd_memory[x][bank])
+            {
+                if (x1 == LCD_CLEAN)
+                    x1 = x;
+                x2 = x;
+                lcd_memory[x][bank] = c;
+                LCD_STAT_BYTES(1);
+            }
+        }
+    }
+    else
+    {
+        n = -dx;
+        for (x = lcd_X_RES; x-- > 0;)
+        {
+            c = (x >= n) ? lcd_memory[x - n][bank] : fill;
+            if (c != lcd_memory[x][bank])
+            {
+                if (x2 == 0)
+                    x2 = x;
+                x1 = x;
+                lcd_memory[x][bank] = c;
+                LCD_STAT_BYTES(1);
+            }
+        }
+    }
+
+    if (x1 == LCD_CLEAN)
+        return; // Nothing changed
+
+    if (lcd_deferred)
+    {
+        lcd_mark(x1, x2, bank);
+        return;
+    }
+
+    lcd_bus_start();
+    lcd_address(x1, bank);
+    for (x = x1; x <= x2; x++)
+        lcd_bus_frame(DATA, lcd_memory[x][bank]);
+    lcd_bus_stop();
+}
+
+//******************************************************************************
+// Horizontal scroll of a band of banks. The columns that enter the screen are cleared
+//  bank1, bank2: 0..8  first and last bank of the band (a bank2 past the screen is taken as 8,
+//                nothing is done if bank1 > bank2)
+//  dx: columns to the left (positive) or to the right (negative)
+void lcd_scroll_h(unsigned char bank1, unsigned char bank2, signed char dx)
+{
+    if (bank2 >= lcd_BANKS)
+        bank2 = lcd_BANKS - 1;
+    for (; bank1 <= bank2; bank1++)
+        lcd_shift_bank(bank1, dx, 0x00);
+}
+
+//******************************************************************************
+// Starts a text ticker running from right to left in one bank. When the text ends it starts over
+//  bank: 0..8  (a bank past the screen is taken as 8)
+//  text: pointer to a string of characters. 0x00 - a sign of the end of the line. Only the pointer
+//        is kept and read on every lcd_ticker_step(), so the text must be a RAM array (global or
+//        static) that stays in place while the ticker runs. Do not pass a string literal: CCS
+//        copies it to a temporary in RAM that is reused after the call
+void lcd_ticker_start(unsigned char bank, char *text)
+{
+    lcd_ticker_text = text;
+    lcd_ticker_char = 0;
+    lcd_ticker_col = 0;
+    lcd_ticker_bank = (bank < lcd_BANKS) ? bank : lcd_BANKS - 1;
+}
+
+//******************************************************************************
+// Moves the ticker one column to the left, the next column of the text enters at the right
+void lcd_ticker_step(void)
+{
+    unsigned char c, bits;
+
+    c = lcd_ticker_text[lcd_ticker_char];
+    if (!c)
+        return; // Empty text
+
+    bits = lcd_char_column(lcd_char_index(c), lcd_ticker_col); // Column 5: space between characters
+
+    if (++lcd_ticker_col == 6)
+    {
+        lcd_ticker_col = 0;
+        if (!lcd_ticker_text[++lcd_ticker_char])
+            lcd_ticker_char = 0;
+    }
+
+    lcd_shift_bank(lcd_ticker_bank, 1, bits);
+}
+
+#endif /* _LCD1100_SCROLL_C_ */
@@ -4,12 +4,22 @@
 #fuses HSM 
 #FUSES NOWDT, NOPROTECT,NOLVP, MCLR
 #include "lcd1100_lib.c"
-#include "scrollingscreen.c"
+#include "lcd1100_scroll.c"
+
+// The ticker reads its text on every step, so it must be a RAM array that stays in place
+static char ticker_text[] = "lcd1100_lib ticker   ";
 
 void main(void) {
 
     lcd_init();
-    movescreen();
+    gotoxy(0, 0);
+    lcd_print("Nokia 1100 LCD");
+    lcd_ticker_start(4, ticker_text);
+
+    while (1) {
+        lcd_ticker_step();
+        delay_ms(40);
+    }
     
 }
 
@@ -0,0 +1,137 @@
+//***************************************************************************
+//  File........: lcd1100_bench.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Linux host (simulated PCF8814)
+//  Compiler....: GCC
+//  Description.: Benchmark of the drawing functions. Runs a fixed workload against the simulated
+//                controller and prints, as CSV, the bus traffic and time of each primitive
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -O2 -o lcd1100_bench sim/lcd1100_bench.c
+// Use:   ./lcd1100_bench [bit rate in Hz, default 4000000]
+//
+// Columns:
+//  primitive   name of the workload (deferred/... for the deferred mode run)
+//  calls       calls made to the primitive
+//  cmd         command frames sent
+//  data        data frames sent
+//  redundant   address setting commands that did not move the controller pointer
+//  bits        bits clocked into the controller
+//  model_us    time of those bits at the given bit rate
+//  sim_us      simulated time of the real bus code (pin changes, delays and MSSP transfers)
+//  frames_s    frames per second achieved in the simulated time
+
+#include "lcd1100_host.h"
+#include "../lcd1100_lib.c"
+#include "pcf8814_sim.c"
+
+static double bench_rate;
+static const char *bench_mode = ""; // Prefix of the workload names
+
+//******************************************************************************
+// Prints one row of results and clears the counters for the next workload
+void bench_row(const char *name, unsigned int calls)
+{
+    double sim_us = sim_time_ns / 1e3;
+    unsigned long frames = sim_cmd_frames + sim_data_frames;
+
+    printf("%s%s,%u,%lu,%lu,%lu,%lu,%.1f,%.1f,%.0f\n", bench_mode, name, calls, sim_cmd_frames, sim_data_frames,
+           sim_redundant, sim_bits, sim_bits * 1e6 / bench_rate, sim_us,
+           sim_us > 0 ? frames * 1e6 / sim_us : 0.0);
+    sim_reset_counters();
+}
+
+//******************************************************************************
+// Fixed workload, the same for every run so results can be compared between versions
+void bench_workload(void)
+{
+    unsigned char i;
+
+    lcd_clear();
+    bench_row("lcd_clear", 1);
+
+    for (i = 0; i < 8; i++)
+    {
+        gotoxy(0, i);
+        lcd_print("0123456789ABCDEF");
+    }
+    bench_row("lcd_print", 8);
+
+    for (i = 0; i < 8; i++)
+    { // The same text again: nothing changes on the screen
+        gotoxy(0, i);
+        lcd_print("0123456789ABCDEF");
+    }
+    bench_row("lcd_print_redraw", 8);
+
+    for (i = 0; i < 32; i++)
+        pix_char((i * 6) % 90, (i * 7) % 60, 'A' + i % 26);
+    bench_row("pix_char", 32);
+
+    for (i = 0; i < 16; i++)
+        lcd_line(0, i * 4, 95, 67 - i * 4, PIXEL_INV);
+    bench_row("lcd_line", 16);
+
+    for (i = 0; i < 8; i++)
+        lcd_line(i * 12, 0, i * 12, 67, PIXEL_ON);
+    bench_row("lcd_line_straight", 8);
+
+    for (i = 1; i <= 8; i++)
+        lcd_circle(47, 33, i * 4, FILL_OFF, PIXEL_INV);
+    bench_row("lcd_circle", 8);
+
+    for (i = 1; i <= 4; i++)
+        lcd_circle(47, 33, i * 8, FILL_ON, PIXEL_INV);
+    bench_row("lcd_circle_fill", 4);
+
+    for (i = 1; i <= 4; i++)
+        lcd_ellipse(47, 33, i * 12, i * 4, FILL_OFF, PIXEL_INV);
+    bench_row("lcd_ellipse", 4);
+
+    for (i = 0; i < 8; i++)
+        lcd_rectangle(i * 4, i * 4, 95 - i * 4, 67 - i * 4, FILL_OFF, PIXEL_INV);
+    bench_row("lcd_rectangle", 8);
+
+    for (i = 0; i < 4; i++)
+        lcd_rectangle(i * 8, i * 5, 95 - i * 8, 67 - i * 5, FILL_ON, PIXEL_INV);
+    bench_row("lcd_rectangle_fill", 4);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_rate = argc > 1 ? atof(argv[1]) : 4000000.0;
+    if (bench_rate <= 0)
+    {
+        fprintf(stderr, "usage: %s [bit rate in Hz]\n", argv[0]);
+        return 1;
+    }
+
+    lcd_init();
+    sim_reset_counters();
+
+    printf("primitive,calls,cmd,data,redundant,bits,model_us,sim_us,frames_s\n");
+    bench_workload();
+
+    // The same workload drawn in deferred mode, sent by a single lcd_flush()
+    bench_mode = "deferred/";
+    lcd_set_deferred(DEFERRED_ON);
+    bench_workload();
+    lcd_set_deferred(DEFERRED_OFF);
+    bench_row("lcd_flush", 1);
+
+    // Wake up with a window of 4 banks after the controller lost its RAM: only those banks are sent,
+    // the others follow when the window grows again
+    bench_mode = "";
+    lcd_window(2, 5);
+    lcd_sleep();
+    bench_row("lcd_sleep", 1);
+    lcd_wake(WAKE_RAM_LOST);
+    bench_row("lcd_wake_window", 1);
+    lcd_window(0, lcd_BANKS - 1);
+    bench_row("lcd_window_full", 1);
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+//***************************************************************************
+//  File........: lcd1100_host.h
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Linux host (simulated PCF8814)
+//  Compiler....: GCC
+//  Description.: Stand-ins for the CCS built-ins used by lcd1100_lib.c, so the library can be
+//                compiled unchanged on a PC against the controller model of pcf8814_sim.c
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+#ifndef _LCD1100_HOST_H_
+#define _LCD1100_HOST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CCS integer types ("unsigned int1" must still be valid)
+#define int1 char
+#define int8 char
+#define int16 short
+#define int32 int
+
+// Pointers to constant data in program memory
+#define rom const
+
+// Simulated CPU clock, replaces getenv("CLOCK") of #use delay
+#ifndef LCD_CPU_HZ
+#define LCD_CPU_HZ 32000000
+#endif
+
+// Port pins of the PIC18F45K50 that may be used by the library
+#define PIN_B1 9
+#define PIN_C7 23
+#define PIN_D3 27
+#define PIN_D4 28
+#define PIN_D5 29
+#define PIN_D6 30
+#define PIN_D7 31
+
+// MSSP configuration flags of setup_spi()
+#define SPI_MASTER 0x20
+#define SPI_L_TO_H 0x00
+#define SPI_XMIT_L_TO_H 0x4000
+#define SPI_CLK_DIV_4 0x00
+#define SPI_CLK_DIV_16 0x01
+#define SPI_CLK_DIV_64 0x02
+
+// Pin, delay and MSSP functions, implemented by the controller model
+void sim_pin(int pin, int level);
+void sim_delay_ns(unsigned long long ns);
+void sim_setup_spi(int mode);
+void sim_spi_write(unsigned char c);
+
+#define output_high(pin) sim_pin(pin, 1)
+#define output_low(pin) sim_pin(pin, 0)
+#define output_bit(pin, level) sim_pin(pin, (level) != 0)
+#define delay_cycles(n) sim_delay_ns((unsigned long long)(n) * 4000000000ULL / LCD_CPU_HZ)
+#define delay_us(n) sim_delay_ns((unsigned long long)(n) * 1000)
+#define delay_ms(n) sim_delay_ns((unsigned long long)(n) * 1000000)
+#define setup_spi(mode) sim_setup_spi(mode)
+#define spi_write(c) sim_spi_write(c)
+
+#endif /* _LCD1100_HOST_H_ */
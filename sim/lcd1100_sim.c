@@ -0,0 +1,45 @@
+//***************************************************************************
+//  File........: lcd1100_sim.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Linux host (simulated PCF8814)
+//  Compiler....: GCC
+//  Description.: Host build of the library against the simulated controller. Draws a test
+//                screen, prints the bus counters and saves the panel as a PBM image
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -o lcd1100_sim sim/lcd1100_sim.c
+// Use:   ./lcd1100_sim [panel.pbm]
+
+#include "lcd1100_host.h"
+#include "../lcd1100_lib.c"
+#include "../lcd1100_dlist.c" // Built with the host tools so the module is compiled
+#include "pcf8814_sim.c"
+
+int main(int argc, char *argv[])
+{
+    const char *path = argc > 1 ? argv[1] : "lcd1100.pbm";
+
+    lcd_init();
+    sim_reset_counters();
+
+    gotoxy(0, 0);
+    lcd_print("Nokia 1100 LCD");
+    pix_print(3, 11, "pix_print");
+    lcd_line(0, 20, 95, 67, PIXEL_ON);
+    lcd_rectangle(60, 24, 90, 40, FILL_ON, PIXEL_ON);
+    lcd_rectangle(4, 24, 40, 60, FILL_OFF, PIXEL_ON);
+    lcd_circle(22, 42, 12, FILL_OFF, PIXEL_ON);
+    lcd_circle(75, 54, 8, FILL_ON, PIXEL_INV);
+
+    sim_report(stdout);
+
+    if (sim_dump_pbm(path))
+    {
+        perror(path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,898 @@
+//***************************************************************************
+//  File........: lcd1100_test.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Linux host (simulated PCF8814)
+//  Compiler....: GCC
+//  Description.: Regression tests of the renderer. Draws fixed scenes and compares the video buffer
+//                and the display RAM of the simulated controller with the golden images of
+//                sim/golden, checks known bugs, then calls the primitives with random arguments
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -fsanitize=address,undefined -fno-sanitize-recover=all -o lcd1100_test sim/lcd1100_test.c
+//        (two panels: add -DLCD_PANELS=2 "-DLCD_CS_PINS={PIN_D6, PIN_D3}")
+// Use:   ./lcd1100_test [-u] [fuzz calls, default 20000] [seed, default 1]
+//
+// Run it from the top folder of the library, the golden images are read from sim/golden. With -u
+// the images are written again from the current drawing code: look at them before committing.
+// The exit status is the number of failed checks (0: all passed).
+
+#include "lcd1100_host.h"
+#include "../lcd1100_lib.c"
+#include "../lcd1100_blit.c"
+#include "../lcd1100_fonts.c"
+#include "../lcd1100_font2.c"
+#include "../lcd1100_scroll.c"
+#include "../lcd1100_console.c"
+#include "../lcd1100_dlist.c"
+#include "../dectobin.c"
+#include "pcf8814_sim.c"
+
+#define TEST_GOLDEN "sim/golden/"
+
+static int test_update;   // -u: write the golden images
+static int test_failures; // Failed checks
+
+// Bitmap of 10 x 12 pixels: a framed box and an arrow below it
+static rom unsigned char test_icon[] = {
+    10, 12,
+    0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xA5, 0xA5, 0xBD, 0x81, 0xFF,
+    0x00, 0x01, 0x03, 0x07, 0x0F, 0x0F, 0x07, 0x03, 0x01, 0x00};
+
+// Constant display list
+static rom unsigned char test_list[] = {
+    DL_RECT(2, 2, 93, 65, 0, PIXEL_ON),
+    DL_LINE(2, 2, 93, 65, PIXEL_ON),
+    DL_CIRCLE(70, 20, 12, 1, PIXEL_INV),
+    DL_PIXEL(10, 60, PIXEL_ON),
+    DL_TEXT(6, 40), 'R', 'O', 'M', ' ', 'l', 'i', 's', 't', 0,
+    DL_END};
+
+//******************************************************************************
+// Reports a failed check
+//  name: scene or check
+//  what: description of the failure
+void test_fail(const char *name, const char *what)
+{
+    printf("FAIL %s: %s\n", name, what);
+    test_failures++;
+}
+
+//******************************************************************************
+// Pixel of the video buffer
+int test_pixel(int x, int y)
+{
+    return (lcd_memory[x][y / 8] >> (y % 8)) & 1;
+}
+
+//******************************************************************************
+// Compares the display RAM of the controller with the video buffer
+//  returns the number of bytes that differ
+int test_ram_diff(void)
+{
+    int x, bank, n = 0;
+
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        for (x = 0; x < lcd_X_RES; x++)
+            if (sim_ddram[bank][x] != lcd_memory[x][bank])
+                n++;
+    return n;
+}
+
+//******************************************************************************
+// Compares the panel as the controller shows it (start line, inverse, display on or off) with the
+// video buffer shown from one of its rows
+//  start: row of the video buffer at the top of the panel
+//  inverse: 1 if the panel must show the buffer inverted
+//  returns the number of pixels that differ
+int test_view_diff(unsigned char start, int inverse)
+{
+    int x, y, n = 0;
+
+    for (y = 0; y < lcd_Y_RES; y++)
+        for (x = 0; x < lcd_X_RES; x++)
+            if (sim_panel_pixel(x, y) != (test_pixel(x, (y + start) % lcd_Y_RES) ^ inverse))
+                n++;
+    return n;
+}
+
+#if LCD_PANELS > 1
+//******************************************************************************
+// Compares the display RAM of the controller on the CS pin of a panel with the video buffer of it
+//  returns the number of bytes that differ
+int test_panel_diff(unsigned char panel)
+{
+    int x, bank, n = 0;
+
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        for (x = 0; x < lcd_X_RES; x++)
+            if (sim_ctl[panel].ddram[bank][x] != lcd_panel_memory[panel][x][bank])
+                n++;
+    return n;
+}
+#endif
+
+//******************************************************************************
+// Starts a scene on a blank screen in direct mode, with the default shade and window, not scrolled
+// and not inverted
+void test_begin(void)
+{
+    lcd_set_deferred(DEFERRED_OFF);
+    lcd_window(0, lcd_BANKS - 1);
+    lcd_scroll_v(0);
+    lcd_inverse(INV_MODE_OFF);
+    lcd_set_shade(16);
+    lcd_clear();
+}
+
+//******************************************************************************
+// Compares the video buffer, the display RAM and the panel with a golden image (P1 PBM of 96 x 68), or
+// writes it. The scene must leave the panel on, not scrolled and not inverted
+//  name: scene, the image is sim/golden/<name>.pbm
+void test_golden(const char *name)
+{
+    char path[64], msg[160];
+    FILE *f;
+    int x, y, w, h, c, bit, bad_buf = 0, bad_ram = 0, bad_panel = 0;
+
+    snprintf(path, sizeof(path), TEST_GOLDEN "%s.pbm", name);
+
+    if (test_ram_diff())
+    {
+        snprintf(msg, sizeof(msg), "%d bytes of the display RAM differ from the video buffer", test_ram_diff());
+        test_fail(name, msg);
+    }
+
+#ifdef LCD_NO_FIXED_FONT
+    return; // The golden images are drawn with lcd_Font
+#endif
+
+    if (test_update)
+    {
+        f = fopen(path, "w");
+        if (!f)
+        {
+            perror(path);
+            test_fail(name, "cannot write the golden image");
+            return;
+        }
+        fprintf(f, "P1\n%d %d\n", lcd_X_RES, lcd_Y_RES);
+        for (y = 0; y < lcd_Y_RES; y++)
+        {
+            for (x = 0; x < lcd_X_RES; x++)
+                fputc(test_pixel(x, y) ? '1' : '0', f);
+            fputc('\n', f);
+        }
+        fclose(f);
+        return;
+    }
+
+    f = fopen(path, "r");
+    if (!f || fscanf(f, "P1 %d %d", &w, &h) != 2 || w != lcd_X_RES || h != lcd_Y_RES)
+    {
+        test_fail(name, "missing or bad golden image");
+        if (f)
+            fclose(f);
+        return;
+    }
+
+    for (y = 0; y < lcd_Y_RES; y++)
+        for (x = 0; x < lcd_X_RES; x++)
+        {
+            do
+                c = fgetc(f);
+            while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+            if (c != '0' && c != '1')
+            {
+                test_fail(name, "golden image too short");
+                fclose(f);
+                return;
+            }
+            bit = c - '0';
+            if (test_pixel(x, y) != bit)
+                bad_buf++;
+            if (((sim_ddram[y / 8][x] >> (y % 8)) & 1) != bit)
+                bad_ram++;
+            if (sim_panel_pixel(x, y) != bit)
+                bad_panel++;
+        }
+    fclose(f);
+
+    if (bad_buf || bad_ram || bad_panel)
+    {
+        snprintf(msg, sizeof(msg), "%d pixels of the video buffer, %d of the display RAM and %d of the panel differ from %s",
+                 bad_buf, bad_ram, bad_panel, path);
+        test_fail(name, msg);
+    }
+}
+
+//******************************************************************************
+// Scenes. Each one draws a screen that is compared with its golden image
+
+void scene_text(void)
+{
+    test_begin();
+    gotoxy(0, 0);
+    lcd_print("Nokia 1100 LCD");
+    gotoxy(2, 1);
+    print_char('#');
+    print_char(0x7F);
+    print_char(0x10); // Out of the font: blank
+    pix_print(3, 13, "pix_print y=13");
+    pix_print(60, 30, "clipped at the right");
+    pix_char(0, 62, 'g'); // Bottom bank
+    pix_print(10, 66, "cut");
+    lcd_inverse(INV_MODE_OFF);
+    test_golden("text");
+}
+
+void scene_lines(void)
+{
+    signed int16 i;
+
+    test_begin();
+    for (i = 0; i < 12; i++)
+        lcd_line(47, 33, -40 + i * 16, (i & 1) ? -30 : 100, PIXEL_ON);
+    for (i = 0; i < 8; i++)
+        lcd_line(0, i * 9, 95, 67 - i * 9, PIXEL_INV);
+    lcd_hline(-10, 200, 5, PIXEL_INV);
+    lcd_vline(90, -10, 200, PIXEL_INV);
+    lcd_line(-5000, 10, 5000, 60, PIXEL_ON); // Long line clipped to the screen
+    lcd_pixel(0, 0, PIXEL_INV);
+    lcd_pixel(95, 67, PIXEL_ON);
+    lcd_pixel(96, 10, PIXEL_ON); // Out of the screen
+    test_golden("lines");
+}
+
+void scene_shapes(void)
+{
+    test_begin();
+    lcd_rectangle(-5, -5, 40, 30, FILL_OFF, PIXEL_ON);
+    lcd_rectangle(50, 4, 90, 20, FILL_ON, PIXEL_ON);
+    lcd_rectangle(60, 10, 100, 40, FILL_ON, PIXEL_INV);
+    lcd_circle(20, 45, 15, FILL_OFF, PIXEL_ON);
+    lcd_circle(20, 45, 8, FILL_ON, PIXEL_INV);
+    lcd_circle(200, 30, 150, FILL_OFF, PIXEL_ON); // Center out of the screen
+    lcd_ellipse(70, 50, 24, 10, FILL_OFF, PIXEL_ON);
+    lcd_arc(70, 50, 12, 6, ARC_TOP_LEFT | ARC_BOTTOM_RIGHT, FILL_ON, PIXEL_INV);
+    lcd_arc(47, 33, 0, 20, ARC_ALL, FILL_OFF, PIXEL_INV); // Degenerate: a vertical line
+    test_golden("shapes");
+}
+
+void scene_shade(void)
+{
+    unsigned char level;
+
+    test_begin();
+    for (level = 0; level <= 16; level++)
+    {
+        lcd_set_shade(level);
+        lcd_rectangle(level * 5, 0, level * 5 + 4, 30, FILL_ON, PIXEL_COPY | PIXEL_PATTERN);
+    }
+    lcd_set_shade(8);
+    lcd_circle(30, 50, 14, FILL_ON, PIXEL_ON | PIXEL_PATTERN);
+    lcd_circle(30, 50, 14, FILL_OFF, PIXEL_ON);
+    lcd_set_shade(4);
+    lcd_rectangle(50, 36, 94, 66, FILL_ON, PIXEL_INV | PIXEL_PATTERN);
+    lcd_line(50, 36, 94, 66, PIXEL_ON | PIXEL_PATTERN);
+    test_golden("shade");
+}
+
+void scene_bitmaps(void)
+{
+    unsigned char mode;
+
+    test_begin();
+    lcd_rectangle(0, 34, 95, 67, FILL_ON, PIXEL_ON);
+    for (mode = PIXEL_ON; mode <= PIXEL_AND; mode++)
+    {
+        lcd_blit(mode * 18 + 2, 4 + mode, test_icon, mode);
+        lcd_blit(mode * 18 + 2, 40 + mode * 3, test_icon, mode);
+    }
+    lcd_blit(-4, 20, test_icon, PIXEL_COPY);
+    lcd_blit(90, 62, test_icon, PIXEL_COPY);
+    lcd_blit(-20, 0, test_icon, PIXEL_COPY); // Out of the screen
+    test_golden("bitmaps");
+}
+
+void scene_fonts(void)
+{
+    test_begin();
+    lcd_set_font(lcd_font_prop, 1);
+    lcd_font_print(0, 0, "Proportional font");
+    lcd_font_print(0, 11, "iiii WWWW 0123");
+    lcd_set_font(lcd_font_prop, 2);
+    lcd_font_print(2, 22, "Big");
+    lcd_set_font(lcd_font_digits, 3);
+    lcd_font_print(40, 40, "12:5");
+    lcd_set_font(lcd_font_digits, 1);
+    lcd_font_print(0, 62, "-0123456789"); // Cut at the bottom
+    test_golden("fonts");
+}
+
+void scene_dlist(void)
+{
+    test_begin();
+    lcd_dl_clear();
+    lcd_dl_fill(0x00);
+    lcd_dl_rectangle(-10, 30, 50, 80, 1, PIXEL_ON);
+    lcd_dl_circle(20, 20, 15, 0, PIXEL_ON);
+    lcd_dl_line(0, 67, 95, 0, PIXEL_INV);
+    lcd_dl_pixel(90, 5, PIXEL_ON);
+    lcd_dl_print(4, 50, "a text longer than the limit");
+    lcd_dl_run();
+    lcd_dl_run_rom(test_list);
+    test_golden("dlist");
+}
+
+void scene_scroll(void)
+{
+    static char text[] = "ticker ";
+    unsigned char i;
+
+    test_begin();
+    lcd_con_init(); // The console draws all its cells: first
+    lcd_con_gotoxy(0, 6);
+    lcd_con_puts("console");
+    lcd_con_refresh();
+
+    gotoxy(0, 0);
+    lcd_print("scroll left");
+    gotoxy(0, 1);
+    lcd_print("scroll right");
+    lcd_scroll_h(0, 0, 20);
+    lcd_scroll_h(1, 1, -20);
+    lcd_ticker_start(4, text);
+    for (i = 0; i < 50; i++)
+        lcd_ticker_step();
+    test_golden("scroll");
+}
+
+void scene_deferred(void)
+{
+    test_begin();
+    lcd_set_deferred(DEFERRED_ON);
+    lcd_circle(47, 33, 30, FILL_ON, PIXEL_ON);
+    pix_print(20, 30, "deferred");
+    lcd_rectangle(10, 10, 85, 57, FILL_OFF, PIXEL_INV);
+    lcd_set_deferred(DEFERRED_OFF);
+
+    // Window of the middle banks, sleep, and a wake up after the controller lost its RAM
+    lcd_window(2, 5);
+    lcd_sleep();
+    lcd_line(0, 0, 95, 67, PIXEL_INV);
+    lcd_wake(WAKE_RAM_LOST);
+    lcd_window(0, lcd_BANKS - 1);
+    test_golden("deferred");
+}
+
+//******************************************************************************
+// Checks of bugs found before
+
+// dectobin(): bit i of the value in bin[i], 1 included, and no write past bin[] from 128 on
+void check_dectobin(void)
+{
+    int d, i;
+
+    for (d = 0; d < 256; d++)
+    {
+        dectobin(d);
+        for (i = 0; i < 7; i++)
+            if (bin[i] != ((d >> i) & 1))
+            {
+                test_fail("dectobin", "wrong bit");
+                return;
+            }
+    }
+}
+
+// Text below the screen is not drawn and does not touch the video buffer
+void check_text_clip(void)
+{
+    static unsigned char copy[lcd_X_RES][lcd_BANKS];
+    int y;
+
+    test_begin();
+    pix_print(0, 10, "reference");
+    memcpy(copy, lcd_memory, sizeof(copy));
+    for (y = lcd_Y_RES; y < 256; y++)
+    {
+        pix_char(90, y, 'A');
+        pix_print(0, y, "AB");
+    }
+    if (memcmp(copy, lcd_memory, sizeof(copy)) || test_ram_diff())
+        test_fail("text_clip", "text below the screen changed it");
+}
+
+// Display list text out of the top left corner shows the same pixels as the text drawn on the screen
+void check_dl_text_clip(void)
+{
+    static unsigned char whole[lcd_X_RES][lcd_BANKS];
+    int dx, dy, x, y;
+
+    for (dy = -7; dy <= 1; dy++)
+        for (dx = -13; dx <= 1; dx++)
+        {
+            test_begin();
+            pix_print(20, 20, "Clip");
+            memcpy(whole, lcd_memory, sizeof(whole));
+
+            test_begin();
+            lcd_dl_clear();
+            lcd_dl_print(dx, dy, "Clip");
+            lcd_dl_run();
+            for (y = 0; y < 30; y++)
+                for (x = 0; x < 40; x++)
+                    if (test_pixel(x, y) != ((x + 20 - dx < lcd_X_RES && y + 20 - dy < lcd_Y_RES)
+                                                 ? (whole[x + 20 - dx][(y + 20 - dy) / 8] >> ((y + 20 - dy) % 8)) & 1
+                                                 : 0))
+                    {
+                        test_fail("dl_text_clip", "text out of the top left corner is not clipped like the shapes");
+                        return;
+                    }
+            if (test_ram_diff())
+                test_fail("dl_text_clip", "display RAM differs from the video buffer");
+        }
+}
+
+// PIXEL_INV shapes invert every pixel once: drawn twice they leave the screen as it was
+void check_inverse(void)
+{
+    static unsigned char copy[lcd_X_RES][lcd_BANKS];
+    int r;
+
+    test_begin();
+    pix_print(0, 20, "background");
+    memcpy(copy, lcd_memory, sizeof(copy));
+    for (r = 0; r < 40; r += 3)
+    {
+        lcd_circle(40, 30, r, r & 1, PIXEL_INV);
+        lcd_ellipse(50, 30, r, r / 2 + 1, FILL_OFF, PIXEL_INV);
+        lcd_line(r, 0, 95 - r, 67, PIXEL_INV);
+    }
+    for (r = 0; r < 40; r += 3)
+    {
+        lcd_circle(40, 30, r, r & 1, PIXEL_INV);
+        lcd_ellipse(50, 30, r, r / 2 + 1, FILL_OFF, PIXEL_INV);
+        lcd_line(r, 0, 95 - r, 67, PIXEL_INV);
+    }
+    if (memcmp(copy, lcd_memory, sizeof(copy)) || test_ram_diff())
+        test_fail("inverse", "PIXEL_INV drawn twice did not restore the screen");
+}
+
+// The panel follows lcd_scroll_v() and lcd_scroll_up(), which wrap at row 64, lcd_inverse() and the
+// display off of lcd_sleep(), without any change to the display RAM
+void check_panel_view(void)
+{
+    static unsigned char rows[] = {0, 1, 20, 63, 64, 200};
+    unsigned char i;
+
+    test_begin();
+    pix_print(0, 0, "top row");
+    lcd_circle(48, 34, 30, FILL_OFF, PIXEL_ON);
+    pix_print(0, 60, "bottom row");
+
+    for (i = 0; i < sizeof(rows); i++)
+    {
+        lcd_scroll_v(rows[i]);
+        if (test_view_diff(rows[i] & 0x3F, 0))
+            test_fail("panel_view", "lcd_scroll_v() did not show the buffer from that row");
+    }
+    lcd_scroll_v(50);
+    lcd_scroll_up(10);
+    lcd_scroll_up(20); // 80: row 16
+    if (test_view_diff(16, 0))
+        test_fail("panel_view", "lcd_scroll_up() did not scroll from the current row");
+
+    lcd_inverse(INV_MODE_ON);
+    if (test_view_diff(16, 1))
+        test_fail("panel_view", "INV_MODE_ON did not invert the panel");
+    lcd_inverse(INV_MODE_OFF);
+
+    lcd_sleep();
+    if (test_view_diff(16, 0) == 0 || sim_display_on)
+        test_fail("panel_view", "lcd_sleep() did not turn the display off");
+    lcd_wake(WAKE_RAM_KEPT);
+    if (test_view_diff(16, 0) || test_ram_diff())
+        test_fail("panel_view", "lcd_wake() did not show the panel as it was");
+    lcd_scroll_v(0);
+}
+
+// A display list run while the panel sleeps keeps the deferred mode lcd_wake() goes back to
+void check_sleep_dlist(void)
+{
+    test_begin();
+    lcd_sleep();
+    lcd_dl_clear();
+    lcd_dl_fill(0xFF);
+    lcd_dl_run();
+    lcd_wake(WAKE_RAM_KEPT);
+    lcd_pixel(0, 0, PIXEL_OFF);
+    if (lcd_get_deferred() != DEFERRED_OFF || test_ram_diff())
+        test_fail("sleep_dlist", "drawing after the wake up did not reach the screen");
+}
+
+// A wake up sends the banks of the window that changed during the sleep, and only them: the changes to
+// the other banks stay marked until the window takes them in
+void check_wake_window(void)
+{
+    unsigned char bank;
+
+    test_begin();
+    lcd_window(2, 5);
+    lcd_sleep();
+    lcd_rectangle(0, 0, lcd_X_RES - 1, lcd_Y_RES - 1, FILL_ON, PIXEL_ON);
+    sim_reset_counters();
+    lcd_wake(WAKE_RAM_KEPT);
+
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        if (bank >= 2 && bank <= 5)
+        {
+            if (sim_bank_data[bank] != lcd_X_RES)
+                test_fail("wake_window", "a bank of the window was not sent whole");
+        }
+        else if (sim_bank_data[bank] || lcd_dirty_x1[bank] == LCD_CLEAN)
+            test_fail("wake_window", "a bank out of the window was sent or lost its marks");
+
+    lcd_window(0, lcd_BANKS - 1);
+    lcd_flush();
+    if (test_ram_diff())
+        test_fail("wake_window", "the marks kept out of the window did not reach the screen");
+}
+
+#if !defined(LCD_NO_FIXED_FONT) && !defined(LCD_FONT_SHIFTED)
+// The cells that LCD_NO_FIXED_FONT takes from lcd_font_prop are the glyphs of lcd_Font, at most one
+// column to the side when their empty columns are not balanced
+void check_text_font(void)
+{
+    unsigned char c, j, cell[5];
+    int d, same;
+
+    lcd_set_text_font(lcd_font_prop);
+    for (c = 0x20; c < 0x80; c++)
+    {
+        for (j = 0; j < 5; j++)
+            cell[j] = lcd_font_cell(c, j);
+        for (d = -1, same = 0; d <= 1 && !same; d++)
+            for (j = 0, same = 1; j < 5; j++)
+                if (cell[j] != ((j + d >= 0 && j + d < 5) ? lcd_Font[c - 0x20][j + d] : 0x00))
+                    same = 0;
+        if (!same)
+        {
+            test_fail("text_font", "a cell of lcd_font_prop is not the glyph of lcd_Font");
+            return;
+        }
+    }
+}
+#endif
+
+// Restart after a reset of the PIC: the controller is wiped (the worst case) while the video buffer
+// and its signature are kept. Returns 1 if lcd_init_poll() got ready within a second
+int warm_restart(unsigned char options)
+{
+    unsigned int16 ms;
+
+    sim_reset();
+    lcd_init_start(options);
+    for (ms = 0; ms < 1000; ms++)
+        if (lcd_init_poll(ms))
+            return 1;
+    return 0;
+}
+
+// A valid signature restores the screen from the video buffer; LCD_INIT_COLD or a bad signature clear it
+void check_warm_restart(void)
+{
+    static unsigned char copy[lcd_X_RES][lcd_BANKS], blank[lcd_X_RES][lcd_BANKS];
+
+    test_begin();
+    pix_print(0, 0, "warm restart");
+    lcd_circle(48, 40, 20, FILL_ON, PIXEL_ON);
+    lcd_scroll_v(20);
+    memcpy(copy, lcd_memory, sizeof(copy));
+
+    if (!warm_restart(0) || !lcd_init_warm)
+        test_fail("warm_restart", "valid signature not taken as a warm restart");
+    else if (memcmp(copy, lcd_memory, sizeof(copy)) || test_ram_diff() || !sim_display_on)
+        test_fail("warm_restart", "screen not restored from the video buffer");
+    else if (sim_start_line != 20)
+        test_fail("warm_restart", "screen not restored at its scroll position");
+
+    if (!warm_restart(LCD_INIT_COLD) || lcd_init_warm || memcmp(blank, lcd_memory, sizeof(blank)) || test_ram_diff() ||
+        sim_start_line != 0)
+        test_fail("warm_restart", "LCD_INIT_COLD did not clear the screen");
+
+    pix_print(0, 0, "warm restart");
+    lcd_magic_inv = 0; // Garbage left in RAM by a power up
+    if (!warm_restart(0) || lcd_init_warm || memcmp(blank, lcd_memory, sizeof(blank)) || test_ram_diff())
+        test_fail("warm_restart", "bad signature did not clear the screen");
+}
+
+#if LCD_PANELS > 1
+// Every panel gets its own drawing: directly, and in deferred mode through lcd_flush_all(), which
+// must leave the selected panel as it was
+void check_panels(void)
+{
+    unsigned char panel;
+
+    for (panel = 0; panel < LCD_PANELS; panel++)
+    {
+        lcd_select(panel);
+        test_begin();
+        lcd_circle(10 + panel * 20, 30, 8, FILL_ON, PIXEL_ON);
+    }
+    for (panel = 0; panel < LCD_PANELS; panel++)
+        if (test_panel_diff(panel) || lcd_panel_memory[panel][10 + panel * 20][3] == 0)
+            test_fail("panels", "direct drawing did not reach the panel it was made on");
+
+    for (panel = 0; panel < LCD_PANELS; panel++)
+    {
+        lcd_select(panel);
+        lcd_set_deferred(DEFERRED_ON);
+        pix_print(0, panel * 10, "panel");
+        lcd_rectangle(50, panel * 8, 90, panel * 8 + 20, FILL_ON, PIXEL_INV);
+    }
+    lcd_select(1);
+    lcd_flush_all();
+    if (lcd_panel != 1)
+        test_fail("panels", "lcd_flush_all() changed the selected panel");
+    for (panel = 0; panel < LCD_PANELS; panel++)
+        if (test_panel_diff(panel))
+            test_fail("panels", "lcd_flush_all() did not bring every panel up to date");
+    if (!memcmp(lcd_panel_memory[0], lcd_panel_memory[1], sizeof(lcd_panel_memory[0])))
+        test_fail("panels", "the panels show the same drawing");
+
+    for (panel = LCD_PANELS; panel-- > 0;)
+    {
+        lcd_select(panel);
+        lcd_set_deferred(DEFERRED_OFF);
+    }
+}
+#endif
+
+//******************************************************************************
+// Kinds of random call of fuzz(), the last one selects panels
+#if LCD_PANELS > 1
+#define FUZZ_KINDS 22
+#else
+#define FUZZ_KINDS 21
+#endif
+
+// Random value between a and b
+int fuzz_rand(int a, int b)
+{
+    return a + rand() % (b - a + 1);
+}
+
+//******************************************************************************
+// Calls the primitives with random arguments, in and out of the screen (coordinates, text cursor,
+// banks), in direct and deferred mode.
+// Memory errors are caught by the sanitizers; the display RAM must match the video buffer whenever
+// the screen is up to date
+//  calls: number of calls
+void fuzz(long calls)
+{
+    static char text[24];
+    rom unsigned char *fonts[2] = {lcd_font_prop, lcd_font_digits};
+    long i;
+    int k, mode;
+
+    test_begin();
+    lcd_set_font(lcd_font_prop, 1);
+
+    for (i = 0; i < calls; i++)
+    {
+        mode = fuzz_rand(PIXEL_ON, PIXEL_AND) | (fuzz_rand(0, 3) ? 0 : PIXEL_PATTERN);
+        for (k = 0; k < (int)sizeof(text) - 1; k++)
+            text[k] = fuzz_rand(0, 4) ? fuzz_rand(0x01, 0xFF) : 0;
+        text[k] = 0;
+
+        switch (fuzz_rand(0, FUZZ_KINDS - 1))
+        {
+        case 0:
+            lcd_pixel(fuzz_rand(-200, 200), fuzz_rand(-200, 200), fuzz_rand(PIXEL_ON, PIXEL_INV));
+            break;
+        case 1:
+            lcd_line(fuzz_rand(-8192, 8191), fuzz_rand(-8192, 8191), fuzz_rand(-300, 300), fuzz_rand(-300, 300),
+                     mode & ~PIXEL_AND);
+            break;
+        case 2:
+            lcd_hline(fuzz_rand(-300, 300), fuzz_rand(-300, 300), fuzz_rand(-100, 100), mode);
+            lcd_vline(fuzz_rand(-100, 200), fuzz_rand(-300, 300), fuzz_rand(-300, 300), mode);
+            break;
+        case 3:
+            lcd_rectangle(fuzz_rand(-300, 300), fuzz_rand(-300, 300), fuzz_rand(-300, 300), fuzz_rand(-300, 300),
+                          fuzz_rand(0, 1), mode);
+            break;
+        case 4:
+            lcd_circle(fuzz_rand(-300, 300), fuzz_rand(-300, 300), fuzz_rand(0, 255), fuzz_rand(0, 1),
+                       mode & ~PIXEL_AND);
+            break;
+        case 5:
+            lcd_arc(fuzz_rand(-300, 300), fuzz_rand(-300, 300), fuzz_rand(0, 255), fuzz_rand(0, 255),
+                    fuzz_rand(0, 255), fuzz_rand(0, 1), mode & ~PIXEL_AND);
+            break;
+        case 6:
+            pix_print(fuzz_rand(0, 255), fuzz_rand(0, 255), text);
+            break;
+        case 7:
+            pix_char(fuzz_rand(0, 255), fuzz_rand(0, 255), fuzz_rand(0, 255));
+            break;
+        case 8:
+            if (fuzz_rand(0, 1))
+                gotoxy(fuzz_rand(0, 30), fuzz_rand(0, 20));
+            else
+                lcd_gotoxy_pix(fuzz_rand(0, 255), fuzz_rand(0, 255));
+            if (fuzz_rand(0, 1))
+                lcd_print(text);
+            else
+                print_char(fuzz_rand(0, 255));
+            break;
+        case 9:
+            lcd_blit(fuzz_rand(-300, 300), fuzz_rand(-300, 300), test_icon, mode & ~PIXEL_PATTERN);
+            break;
+        case 10:
+            lcd_set_font(fonts[fuzz_rand(0, 1)], fuzz_rand(0, 5));
+            lcd_font_print(fuzz_rand(0, 255), fuzz_rand(0, 255), text);
+            break;
+        case 11:
+            lcd_dl_clear();
+            for (k = fuzz_rand(0, 12); k > 0; k--)
+                switch (fuzz_rand(0, 5))
+                {
+                case 0:
+                    lcd_dl_pixel(fuzz_rand(-128, 127), fuzz_rand(-128, 127), mode);
+                    break;
+                case 1:
+                    lcd_dl_line(fuzz_rand(-128, 127), fuzz_rand(-128, 127), fuzz_rand(-128, 127),
+                                fuzz_rand(-128, 127), mode);
+                    break;
+                case 2:
+                    lcd_dl_rectangle(fuzz_rand(-128, 127), fuzz_rand(-128, 127), fuzz_rand(-128, 127),
+                                     fuzz_rand(-128, 127), fuzz_rand(0, 1), mode);
+                    break;
+                case 3:
+                    lcd_dl_circle(fuzz_rand(-128, 127), fuzz_rand(-128, 127), fuzz_rand(0, 255), fuzz_rand(0, 1),
+                                  mode);
+                    break;
+                case 4:
+                    lcd_dl_print(fuzz_rand(-128, 127), fuzz_rand(-128, 127), text);
+                    break;
+                case 5:
+                    lcd_dl_fill(fuzz_rand(0, 255));
+                    break;
+                }
+            lcd_dl_run();
+            break;
+        case 12:
+            lcd_dl_run_rom(test_list);
+            break;
+        case 13:
+            if (fuzz_rand(0, 1))
+                lcd_scroll_h(fuzz_rand(0, 20), fuzz_rand(0, 20), fuzz_rand(-128, 127));
+            else
+            {
+                lcd_ticker_start(fuzz_rand(0, 20), text);
+                for (k = fuzz_rand(0, 40); k > 0; k--)
+                    lcd_ticker_step();
+            }
+            break;
+        case 14:
+            lcd_con_gotoxy(fuzz_rand(0, 20), fuzz_rand(0, 10));
+            lcd_con_puts(text);
+            lcd_con_refresh();
+            break;
+        case 15:
+            lcd_set_shade(fuzz_rand(0, 20));
+            break;
+        case 16:
+            lcd_set_deferred(fuzz_rand(0, 1));
+            break;
+        case 17:
+            lcd_window(fuzz_rand(0, 12), fuzz_rand(0, 12));
+            break;
+        case 18:
+            if (fuzz_rand(0, 1))
+                lcd_sleep();
+            else
+                lcd_wake(fuzz_rand(WAKE_RAM_KEPT, WAKE_RAM_LOST));
+            break;
+        case 19:
+            lcd_fill_bank(fuzz_rand(0, 20), fuzz_rand(0, 255));
+            break;
+        case 20:
+            k = fuzz_rand(0, 2);
+            if (k == 0)
+                lcd_scroll_v(fuzz_rand(0, 255));
+            else if (k == 1)
+                lcd_scroll_up(fuzz_rand(0, 255));
+            else
+                lcd_inverse(fuzz_rand(INV_MODE_ON, INV_MODE_OFF));
+            break;
+#if LCD_PANELS > 1
+        case 21:
+            if (fuzz_rand(0, 1))
+                lcd_select(fuzz_rand(0, LCD_PANELS));
+            else
+                lcd_flush_all();
+            break;
+#endif
+        }
+
+        if (i % 1000 == 999 || i == calls - 1)
+        { // Bring the screens up to date and compare them and the panels with the video buffers
+            for (k = LCD_PANELS; k-- > 0;)
+            {
+                lcd_select(k);
+                lcd_wake(WAKE_RAM_KEPT);
+                lcd_window(0, lcd_BANKS - 1);
+                lcd_set_deferred(DEFERRED_OFF);
+                lcd_inverse(INV_MODE_OFF);
+                sim_select(k);
+                if (test_ram_diff() || test_view_diff(lcd_start_row, 0))
+                {
+                    test_fail("fuzz", "display RAM or panel differs from the video buffer");
+                    sim_select(0);
+                    return;
+                }
+            }
+            sim_select(0);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long calls = 20000;
+    unsigned int seed = 1;
+    int arg = 1;
+
+    if (arg < argc && !strcmp(argv[arg], "-u"))
+    {
+        test_update = 1;
+        arg++;
+    }
+    if (arg < argc)
+        calls = atol(argv[arg++]);
+    if (arg < argc)
+        seed = strtoul(argv[arg++], NULL, 0);
+
+    lcd_init();
+#ifdef LCD_NO_FIXED_FONT
+    lcd_set_text_font(lcd_font_prop);
+#endif
+
+    scene_text();
+    scene_lines();
+    scene_shapes();
+    scene_shade();
+    scene_bitmaps();
+    scene_fonts();
+    scene_dlist();
+    scene_scroll();
+    scene_deferred();
+
+    check_dectobin();
+    check_text_clip();
+    check_dl_text_clip();
+    check_inverse();
+    check_panel_view();
+    check_sleep_dlist();
+    check_wake_window();
+#if !defined(LCD_NO_FIXED_FONT) && !defined(LCD_FONT_SHIFTED)
+    check_text_font();
+#endif
+    check_warm_restart();
+#if LCD_PANELS > 1
+    check_panels();
+#endif
+
+    srand(seed);
+    fuzz(calls);
+
+    printf("%s: %d failed checks (%ld fuzz calls, seed %u)\n", test_update ? "golden images written" : "done",
+           test_failures, calls, seed);
+    return test_failures;
+}
@@ -0,0 +1,335 @@
+//***************************************************************************
+//  File........: pcf8814_sim.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Linux host (simulated PCF8814)
+//  Compiler....: GCC
+//  Description.: Pin level model of the PCF8814 controller of the Nokia 1100 LCD. It decodes the
+//                9-bit serial frames, keeps the display RAM and the address pointers, counts the
+//                transferred bits and the simulated time and dumps the panel as a PBM image. With
+//                LCD_PANELS > 1 there is one controller on each CS pin of LCD_CS_PINS
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Include after lcd1100_host.h and lcd1100_lib.c, the model uses the pin definitions of the library
+
+#ifndef _PCF8814_SIM_C_
+#define _PCF8814_SIM_C_
+
+#define SIM_NS_PER_CYCLE (4000000000ULL / LCD_CPU_HZ) // A pin change takes one instruction cycle
+
+// Display RAM, registers and frame being received of each controller. The names used by the model
+// and the tests stand for the fields of the controller chosen with sim_select(), as in the library
+typedef struct
+{
+    unsigned char ddram[lcd_BANKS][lcd_X_RES];
+    unsigned char x, bank, start_line;
+    int display_on, inverse, all_on;
+    int selected; // CS low
+    unsigned int shift, nbits;
+} sim_ctl_t;
+
+static sim_ctl_t sim_ctl[LCD_PANELS];
+static unsigned char sim_panel; // Selected controller
+
+#define sim_ddram sim_ctl[sim_panel].ddram
+#define sim_x sim_ctl[sim_panel].x
+#define sim_bank sim_ctl[sim_panel].bank
+#define sim_start_line sim_ctl[sim_panel].start_line
+#define sim_display_on sim_ctl[sim_panel].display_on
+#define sim_inverse sim_ctl[sim_panel].inverse
+#define sim_all_on sim_ctl[sim_panel].all_on
+#define sim_shift sim_ctl[sim_panel].shift
+#define sim_nbits sim_ctl[sim_panel].nbits
+
+#if LCD_PANELS > 1
+#define SIM_CS_PIN(panel) lcd_cs_pins[panel]
+#else
+#define SIM_CS_PIN(panel) CS
+#endif
+
+// Serial interface: levels of the shared pins
+static int sim_sclk, sim_sda, sim_rst = 1;
+static int sim_spi_div = 4;
+
+// Counters, cleared by sim_reset_counters()
+static unsigned long sim_bits;          // Bits clocked into the controller
+static unsigned long sim_cmd_frames;    // Command frames
+static unsigned long sim_data_frames;   // Data frames
+static unsigned long sim_addr_frames;   // Address setting commands (Y, X upper and X lower)
+static unsigned long sim_redundant;     // Address setting commands that did not move the pointer
+static unsigned long sim_bank_data[lcd_BANKS]; // Data frames written to each bank
+static unsigned long long sim_time_ns;  // Simulated time
+
+//******************************************************************************
+// Clears the counters and the simulated time
+void sim_reset_counters(void)
+{
+    sim_bits = 0;
+    sim_cmd_frames = 0;
+    sim_data_frames = 0;
+    sim_addr_frames = 0;
+    sim_redundant = 0;
+    memset(sim_bank_data, 0, sizeof(sim_bank_data));
+    sim_time_ns = 0;
+#ifdef LCD_STATS
+    lcd_stats_clear();
+#endif
+}
+
+//******************************************************************************
+// Selects the controller seen by sim_ddram, sim_panel_pixel(), sim_dump_pbm()...
+//  panel: 0..LCD_PANELS-1
+void sim_select(unsigned char panel)
+{
+    if (panel < LCD_PANELS)
+        sim_panel = panel;
+}
+
+//******************************************************************************
+// Reset of the controllers (RST low, shared by all of them)
+void sim_reset(void)
+{
+    unsigned char panel;
+
+    for (panel = 0; panel < LCD_PANELS; panel++)
+    {
+        sim_ctl_t *ctl = &sim_ctl[panel];
+
+        memset(ctl->ddram, 0, sizeof(ctl->ddram));
+        ctl->x = 0;
+        ctl->bank = 0;
+        ctl->start_line = 0;
+        ctl->display_on = 0;
+        ctl->inverse = 0;
+        ctl->all_on = 0;
+        ctl->nbits = 0;
+    }
+}
+
+//******************************************************************************
+// Execution of a command frame
+void sim_command(unsigned char c)
+{
+    unsigned char before;
+
+    sim_cmd_frames++;
+
+    if ((c & 0xF0) == 0xB0)
+    { // Y address (bank)
+        sim_addr_frames++;
+        if ((c & 0x0F) == sim_bank)
+            sim_redundant++;
+        if ((c & 0x0F) < lcd_BANKS)
+            sim_bank = c & 0x0F;
+    }
+    else if (c <= 0x17)
+    { // X address, lower 4 bits (0x00..0x0F) or upper 3 bits (0x10..0x17)
+        sim_addr_frames++;
+        before = sim_x;
+        if (c & 0x10)
+            sim_x = (sim_x & 0x0F) | ((c & 0x07) << 4);
+        else
+            sim_x = (sim_x & 0x70) | (c & 0x0F);
+        if (sim_x == before)
+            sim_redundant++;
+    }
+    else if ((c & 0xC0) == 0x40)
+        sim_start_line = c & 0x3F;
+    else if ((c & 0xFE) == 0xA4)
+        sim_all_on = c & 0x01;
+    else if ((c & 0xFE) == 0xA6)
+        sim_inverse = c & 0x01;
+    else if ((c & 0xFE) == 0xAE)
+        sim_display_on = c & 0x01;
+}
+
+//******************************************************************************
+// Execution of a data frame: written at the pointer, which moves to the next column and after the
+// last column to the start of the next bank
+void sim_data(unsigned char c)
+{
+    sim_data_frames++;
+
+    if (sim_x < lcd_X_RES && sim_bank < lcd_BANKS)
+    {
+        sim_ddram[sim_bank][sim_x] = c;
+        sim_bank_data[sim_bank]++;
+    }
+
+    if (++sim_x >= lcd_X_RES)
+    {
+        sim_x = 0;
+        if (++sim_bank >= lcd_BANKS)
+            sim_bank = 0;
+    }
+}
+
+//******************************************************************************
+// One bit of the serial interface, taken on the rising edge of SCLK
+void sim_bit(int level)
+{
+    sim_bits++;
+    sim_shift = (sim_shift << 1) | (level != 0);
+
+    if (++sim_nbits == 9)
+    {
+        if (sim_shift & 0x100)
+            sim_data(sim_shift & 0xFF);
+        else
+            sim_command(sim_shift & 0xFF);
+        sim_nbits = 0;
+        sim_shift = 0;
+    }
+}
+
+//******************************************************************************
+// One bit of the serial interface, received by every controller whose CS is low
+void sim_bus_bit(int level)
+{
+    unsigned char selected = sim_panel, panel;
+
+    if (!sim_rst)
+        return;
+    for (panel = 0; panel < LCD_PANELS; panel++)
+        if (sim_ctl[panel].selected)
+        {
+            sim_panel = panel;
+            sim_bit(level);
+        }
+    sim_panel = selected;
+}
+
+//******************************************************************************
+// Change of a port pin
+void sim_pin(int pin, int level)
+{
+    unsigned char panel;
+
+    sim_time_ns += SIM_NS_PER_CYCLE;
+
+    if (pin == RST)
+    {
+        if (!level)
+            sim_reset();
+        sim_rst = level;
+    }
+    else if (pin == SDA)
+        sim_sda = level;
+    else if (pin == SCLK)
+    {
+        if (level && !sim_sclk)
+            sim_bus_bit(sim_sda);
+        sim_sclk = level;
+    }
+    else
+        for (panel = 0; panel < LCD_PANELS; panel++)
+            if (pin == SIM_CS_PIN(panel))
+            {
+                if (level)
+                    sim_ctl[panel].nbits = 0; // An unfinished frame is discarded
+                sim_ctl[panel].selected = !level;
+            }
+}
+
+//******************************************************************************
+// Busy wait
+void sim_delay_ns(unsigned long long ns)
+{
+    sim_time_ns += ns;
+}
+
+//******************************************************************************
+// MSSP configuration, only the clock division matters to the model
+void sim_setup_spi(int mode)
+{
+    static const int div[] = {4, 16, 64};
+
+    sim_spi_div = div[mode & 0x03];
+}
+
+//******************************************************************************
+// MSSP transfer of one byte, MSB first
+void sim_spi_write(unsigned char c)
+{
+    int i;
+
+    for (i = 7; i >= 0; i--)
+        sim_bus_bit((c >> i) & 1);
+    sim_time_ns += 8 * sim_spi_div * 1000000000ULL / LCD_CPU_HZ + SIM_NS_PER_CYCLE;
+}
+
+//******************************************************************************
+// State of a pixel of the panel as seen by the user, with the start line, inversion and the
+// all points on and display on/off modes applied
+//  x: 0..95
+//  y: 0..67
+int sim_panel_pixel(int x, int y)
+{
+    int row = (y + sim_start_line) % lcd_Y_RES;
+    int on = (sim_ddram[row / 8][x] >> (row % 8)) & 1;
+
+    if (!sim_display_on)
+        return 0;
+    if (sim_all_on)
+        return 1;
+    return on ^ sim_inverse;
+}
+
+//******************************************************************************
+// Writes the panel as a plain PBM image (P1, 1 = dark pixel)
+//  path: file name
+//  returns 0 on success
+int sim_dump_pbm(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    int x, y;
+
+    if (!f)
+        return -1;
+
+    fprintf(f, "P1\n%d %d\n", lcd_X_RES, lcd_Y_RES);
+    for (y = 0; y < lcd_Y_RES; y++)
+    {
+        for (x = 0; x < lcd_X_RES; x++)
+            fputc(sim_panel_pixel(x, y) ? '1' : '0', f);
+        fputc('\n', f);
+    }
+
+    return fclose(f);
+}
+
+//******************************************************************************
+// Prints the counters
+//  f: output stream
+void sim_report(FILE *f)
+{
+    int bank;
+
+    fprintf(f, "bits          %lu\n", sim_bits);
+    fprintf(f, "cmd frames    %lu\n", sim_cmd_frames);
+    fprintf(f, "data frames   %lu\n", sim_data_frames);
+    fprintf(f, "addr frames   %lu (%lu redundant)\n", sim_addr_frames, sim_redundant);
+    fprintf(f, "bank frames  ");
+    for (bank = 0; bank < lcd_BANKS; bank++)
+        fprintf(f, " %lu", sim_bank_data[bank]);
+    fprintf(f, "\n");
+    fprintf(f, "time          %.3f ms\n", sim_time_ns / 1e6);
+
+#ifdef LCD_STATS
+    { // Counters of the library itself (build with -DLCD_STATS)
+        static const char *kinds[LCD_STAT_KINDS] = {"other", "pixel", "line",  "rect", "arc",
+                                                    "text",  "blit",  "font", "fill", "flush"};
+        int k;
+
+        fprintf(f, "primitive     calls    cmd   data  bytes\n");
+        for (k = 0; k < LCD_STAT_KINDS; k++)
+            if (lcd_stats[k].calls || lcd_stats[k].cmd || lcd_stats[k].data || lcd_stats[k].bytes)
+                fprintf(f, "%-12s %6u %6u %6u %6u\n", kinds[k], lcd_stats[k].calls, lcd_stats[k].cmd,
+                        lcd_stats[k].data, lcd_stats[k].bytes);
+    }
+#endif
+}
+
+#endif /* _PCF8814_SIM_C_ */
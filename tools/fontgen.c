@@ -0,0 +1,214 @@
+//***************************************************************************
+//  File........: fontgen.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Host PC
+//  Compiler....: GCC
+//  Description.: Generates the pre-shifted glyph tables of the 5x7 font from a font image, for text
+//                at any row without shifting at run time, optionally only for the characters used
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -o fontgen tools/fontgen.c
+// Use:   ./fontgen tools/font1.pbm ["characters"] > lcd1100_fontshift.c
+//
+// The font image is a PBM (P1 or P4) of 96 x 48 pixels: 6 lines of 16 cells of 6 x 8 pixels,
+// holding the characters 0x20..0x7F in order. Each glyph takes the 5 columns and 7 rows at the upper
+// left corner of its cell. tools/font1.pbm is the font of lcd1100_font1.c.
+//
+// With a list of characters only those are generated (subset mode) and the other ones are drawn as
+// blanks. Include the output before lcd1100_lib.c; it then replaces lcd1100_font1.c.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#define GEN_FIRST 0x20
+#define GEN_COUNT 96
+#define GEN_CELL_W 6
+#define GEN_CELL_H 8
+#define GEN_PER_LINE 16
+#define GEN_WIDTH (GEN_PER_LINE * GEN_CELL_W)
+#define GEN_HEIGHT (GEN_COUNT / GEN_PER_LINE * GEN_CELL_H)
+#define GEN_NONE 0xFF // LCD_NO_CHAR of lcd1100_lib.c
+#define GEN_ROWS 7    // Rows of the glyphs
+#define GEN_SPLIT (8 - GEN_ROWS + 1) // First shift that pushes rows into the next bank
+#define GEN_BYTES (8 * 5 + (8 - GEN_SPLIT) * 5) // Bytes of a character
+
+static unsigned char pixels[GEN_HEIGHT][GEN_WIDTH];
+
+//******************************************************************************
+// Reads the next number of the header, skipping blanks and comments
+//  f: input stream
+//  returns the number, -1 on error
+int pbm_number(FILE *f)
+{
+    int c, n = 0, digits = 0;
+
+    do
+    {
+        c = fgetc(f);
+        if (c == '#')
+            while (c != '\n' && c != EOF)
+                c = fgetc(f);
+    } while (isspace(c));
+
+    while (isdigit(c))
+    {
+        n = n * 10 + c - '0';
+        digits++;
+        c = fgetc(f);
+    }
+
+    return digits ? n : -1;
+}
+
+//******************************************************************************
+// Loads the font image into pixels[]
+//  path: file name
+//  returns 0 on success
+int pbm_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    int raw, x, y, c = 0;
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+
+    if (fgetc(f) != 'P' || ((c = fgetc(f)) != '1' && c != '4'))
+    {
+        fprintf(stderr, "%s: not a PBM image\n", path);
+        return -1;
+    }
+    raw = (c == '4');
+
+    if (pbm_number(f) != GEN_WIDTH || pbm_number(f) != GEN_HEIGHT)
+    {
+        fprintf(stderr, "%s: the image must be %d x %d pixels\n", path, GEN_WIDTH, GEN_HEIGHT);
+        return -1;
+    }
+
+    for (y = 0; y < GEN_HEIGHT; y++)
+        for (x = 0; x < GEN_WIDTH; x++)
+        {
+            if (raw)
+            {
+                if (x % 8 == 0)
+                    c = fgetc(f);
+                pixels[y][x] = (c >> (7 - x % 8)) & 1;
+            }
+            else
+            {
+                do
+                    c = fgetc(f);
+                while (isspace(c));
+                pixels[y][x] = (c == '1');
+            }
+            if (c == EOF)
+            {
+                fprintf(stderr, "%s: image data too short\n", path);
+                return -1;
+            }
+        }
+
+    return fclose(f);
+}
+
+//******************************************************************************
+// Column of a glyph as in lcd_Font, bit 0 on top
+//  c: character code
+//  j: 0..4  column
+unsigned char glyph_column(int c, int j)
+{
+    int x = (c - GEN_FIRST) % GEN_PER_LINE * GEN_CELL_W + j;
+    int y = (c - GEN_FIRST) / GEN_PER_LINE * GEN_CELL_H;
+    unsigned char bits = 0;
+    int row;
+
+    for (row = 0; row < GEN_ROWS; row++)
+        bits |= pixels[y + row][x] << row;
+
+    return bits;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned char index[GEN_COUNT];
+    int used[GEN_COUNT] = {0};
+    int count = 0, c, s, j, n;
+    const char *p;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s font.pbm [\"characters\"]\n", argv[0]);
+        return 1;
+    }
+    if (pbm_load(argv[1]))
+        return 1;
+
+    for (c = 0; c < GEN_COUNT; c++)
+        used[c] = (argc == 2);
+    if (argc == 3)
+        for (p = argv[2]; *p; p++)
+            if ((unsigned char)*p >= GEN_FIRST && (unsigned char)*p < GEN_FIRST + GEN_COUNT)
+                used[(unsigned char)*p - GEN_FIRST] = 1;
+
+    for (c = 0; c < GEN_COUNT; c++)
+        index[c] = used[c] ? count++ : GEN_NONE;
+    if (!count)
+    {
+        fprintf(stderr, "no characters 0x%02X..0x%02X in the list\n", GEN_FIRST, GEN_FIRST + GEN_COUNT - 1);
+        return 1;
+    }
+
+    printf("// Pre-shifted 5x7 font made from %s with tools/fontgen.c, %d characters, %d bytes\n", argv[1], count,
+           count * GEN_BYTES + (argc == 3 ? GEN_COUNT : 0));
+    printf("// Include before lcd1100_lib.c\n\n");
+    printf("#define LCD_FONT_SHIFTED\n");
+
+    if (argc == 3)
+    {
+        printf("#define LCD_FONT_SUBSET\n\n");
+        printf("// Position of the characters 0x20..0x7F in lcd_FontShift, 0x%02X - not generated\n", GEN_NONE);
+        printf("const unsigned char lcd_FontIndex[%d] = {", GEN_COUNT);
+        for (c = 0; c < GEN_COUNT; c++)
+            printf("%s0x%02X%s", c % 16 == 0 ? "\n    " : " ", index[c], c < GEN_COUNT - 1 ? "," : "\n");
+        printf("};\n");
+    }
+
+    // Only the shifts from GEN_SPLIT on have rows in the next bank, the other halves would be all zeros
+    printf("\n// [character][LCD_FONT_SHIFT_AT(row, next) + column]: the 5 columns of the character beginning at a\n");
+    printf("// row of the bank, in that bank (next = 0) or in the next one (next = 1, rows %d..7 only)\n", GEN_SPLIT);
+    printf("#define LCD_FONT_SHIFT_AT(row, next) ((next) ? %d + (row) * 5 : (row) * 5)\n", 8 * 5 - GEN_SPLIT * 5);
+    printf("const unsigned char lcd_FontShift[%d][%d] = {\n", count, GEN_BYTES);
+    for (c = 0, n = 0; c < GEN_COUNT; c++)
+    {
+        if (!used[c])
+            continue;
+
+        printf("    { // '%c'\n", c + GEN_FIRST < 0x7E ? c + GEN_FIRST : '?');
+        for (s = 0; s < 8; s++)
+        {
+            printf("        ");
+            for (j = 0; j < 5; j++)
+                printf("0x%02X,%s", (glyph_column(c + GEN_FIRST, j) << s) & 0xFF, j < 4 ? " " : "");
+            printf(" // Row %d\n", s);
+        }
+        for (s = GEN_SPLIT; s < 8; s++)
+        {
+            printf("        ");
+            for (j = 0; j < 5; j++)
+                printf("0x%02X%s", glyph_column(c + GEN_FIRST, j) >> (8 - s),
+                       j < 4 ? ", " : (s < 7 ? "," : ""));
+            printf(" // Row %d, next bank\n", s);
+        }
+        printf("    }%s\n", ++n < count ? "," : "");
+    }
+    printf("};\n");
+
+    return 0;
+}
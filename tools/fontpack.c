@@ -0,0 +1,161 @@
+//***************************************************************************
+//  File........: fontpack.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Host PC
+//  Compiler....: GCC
+//  Description.: Builds fonts for lcd1100_fonts.c from the lcd_Font table of lcd1100_font1.c,
+//                optionally proportional, compressing every glyph whose data gets shorter
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -o fontpack tools/fontpack.c
+// Use:   ./fontpack name first last [-p] > font.c
+//
+//  name: name of the array
+//  first, last: first and last character, as a character or a number (e.g. 0 9, 0x20 0x7F)
+//  -p: proportional, the empty columns at both sides of every glyph are removed. The space keeps
+//      PACK_SPACE columns. Without it the font has fixed width and no tables, which takes the least
+//      program memory (e.g. digits for 2x/3x clocks)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lcd1100_font1.c"
+
+#define PACK_FIRST 0x20 // Code of lcd_Font[0]
+#define PACK_COUNT (int)(sizeof(lcd_Font) / sizeof(lcd_Font[0]))
+#define PACK_HEIGHT 7   // Rows used by lcd_Font
+#define PACK_SPACE 2    // Width of the space in proportional fonts
+#define PACK_RLE 0x80   // LCD_GLYPH_RLE of lcd1100_fonts.c
+
+static unsigned char data[PACK_COUNT * 16];
+static int data_size;
+
+//******************************************************************************
+// Compresses bytes with PackBits
+//  in, n: bytes to compress
+//  out: room for n + n / 128 + 1 bytes
+//  returns the size of the compressed data
+int pack_bits(const unsigned char *in, int n, unsigned char *out)
+{
+    int i = 0, size = 0, run, lit;
+
+    while (i < n)
+    {
+        for (run = 1; i + run < n && run < 128 && in[i + run] == in[i]; run++)
+            ;
+        if (run >= 2)
+        {
+            out[size++] = 257 - run;
+            out[size++] = in[i];
+            i += run;
+            continue;
+        }
+
+        // Literal bytes up to the next run of 2 or more
+        for (lit = 1; i + lit < n && lit < 128; lit++)
+            if (i + lit + 1 < n && in[i + lit] == in[i + lit + 1])
+                break;
+        out[size++] = lit - 1;
+        memcpy(out + size, in + i, lit);
+        size += lit;
+        i += lit;
+    }
+
+    return size;
+}
+
+//******************************************************************************
+// Reads a character argument: a single character or a number
+int pack_char(const char *s)
+{
+    if (s[0] && !s[1])
+        return (unsigned char)s[0];
+    return (int)strtol(s, NULL, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int first, last, prop, c, a, b, width, size, count, tables, plain = 0;
+    int widths[256], offsets[256];
+    unsigned char packed[16];
+
+    if (argc < 4 || argc > 5 || (argc == 5 && strcmp(argv[4], "-p")))
+    {
+        fprintf(stderr, "usage: %s name first last [-p]\n", argv[0]);
+        return 1;
+    }
+    first = pack_char(argv[2]);
+    last = pack_char(argv[3]);
+    prop = (argc == 5);
+    if (first < PACK_FIRST || last >= PACK_FIRST + PACK_COUNT || first > last)
+    {
+        fprintf(stderr, "characters must be 0x%02X..0x%02X\n", PACK_FIRST, PACK_FIRST + PACK_COUNT - 1);
+        return 1;
+    }
+
+    for (c = first; c <= last; c++)
+    {
+        const unsigned char *glyph = lcd_Font[c - PACK_FIRST];
+
+        // Columns a..b of the glyph are kept
+        a = 0;
+        b = 4;
+        if (prop)
+        {
+            while (a <= b && !glyph[a])
+                a++;
+            while (b >= a && !glyph[b])
+                b--;
+        }
+        width = b - a + 1;
+        if (width <= 0)
+        { // Empty glyph (space)
+            a = 0;
+            width = PACK_SPACE;
+        }
+        plain += width;
+
+        offsets[c] = data_size;
+        size = pack_bits(glyph + a, width, packed);
+        if (prop && size < width)
+        {
+            widths[c] = width | PACK_RLE;
+            memcpy(data + data_size, packed, size);
+            data_size += size;
+        }
+        else
+        {
+            widths[c] = width;
+            memcpy(data + data_size, glyph + a, width);
+            data_size += width;
+        }
+    }
+
+    printf("// %s: characters 0x%02X..0x%02X of lcd_Font%s, made with tools/fontpack.c\n", argv[1], first, last,
+           prop ? ", proportional" : "");
+    count = last - first + 1;
+    tables = prop ? count + (count + 7) / 8 * 2 : 0;
+    printf("// %d bytes (%d of glyph data, %d uncompressed)\n", 4 + tables + data_size, data_size, plain);
+    printf("rom unsigned char %s[] = {\n", argv[1]);
+    printf("    %d, 0x%02X, %d, %d,\n", PACK_HEIGHT, first, count, prop ? 0 : 5);
+    if (prop)
+    {
+        // Widths, then the offset of every 8th glyph
+        for (c = first; c <= last; c++)
+            printf("%s0x%02X,%s", (c - first) % 12 == 0 ? "    " : " ", widths[c],
+                   (c - first) % 12 == 11 || c == last ? "\n" : "");
+        for (c = first; c <= last; c += 8)
+            printf("%s0x%02X, 0x%02X,%s", (c - first) % 48 == 0 ? "    " : " ", offsets[c] & 0xFF, offsets[c] >> 8,
+                   (c - first) % 48 == 40 || c + 8 > last ? "\n" : "");
+    }
+    for (a = 0; a < data_size; a++)
+        printf("%s0x%02X%s", a % 12 == 0 ? "    " : " ", data[a],
+               a == data_size - 1 ? "\n" : (a % 12 == 11 ? ",\n" : ","));
+    printf("};\n");
+
+    return 0;
+}
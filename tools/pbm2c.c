@@ -0,0 +1,131 @@
+//***************************************************************************
+//  File........: pbm2c.c
+//  Author(s)...: JMRMEDEV
+//  URL(s)......: https://github.com/JMRMEDEV/lcd1100/
+//  Device(s)...: Host PC
+//  Compiler....: GCC
+//  Description.: Converts a PBM image (P1 or P4) into a bitmap for lcd_blit(), printed as a C
+//                array in program memory
+//  Date........: 17.10.26
+//  Version.....: 0.0.1
+//***************************************************************************
+
+// Build: gcc -o pbm2c tools/pbm2c.c
+// Use:   ./pbm2c image.pbm name > image.c
+//
+// Black pixels (1 in the PBM file) are the pixels turned on. The image must be 255 x 255 pixels
+// at most.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+//******************************************************************************
+// Reads the next number of the header, skipping blanks and comments
+//  f: input stream
+//  returns the number, -1 on error
+int pbm_number(FILE *f)
+{
+    int c, n = 0, digits = 0;
+
+    do
+    {
+        c = fgetc(f);
+        if (c == '#')
+            while (c != '\n' && c != EOF)
+                c = fgetc(f);
+    } while (isspace(c));
+
+    while (isdigit(c))
+    {
+        n = n * 10 + c - '0';
+        digits++;
+        c = fgetc(f);
+    }
+
+    return digits ? n : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *f;
+    unsigned char *pixels;
+    int width, height, raw, x, y, c, bit, line, lines, n;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s image.pbm name\n", argv[0]);
+        return 1;
+    }
+
+    f = fopen(argv[1], "rb");
+    if (!f)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fgetc(f) != 'P' || ((c = fgetc(f)) != '1' && c != '4'))
+    {
+        fprintf(stderr, "%s: not a PBM image\n", argv[1]);
+        return 1;
+    }
+    raw = (c == '4');
+
+    width = pbm_number(f);
+    height = pbm_number(f);
+    if (width < 1 || width > 255 || height < 1 || height > 255)
+    {
+        fprintf(stderr, "%s: size must be 1..255 x 1..255\n", argv[1]);
+        return 1;
+    }
+
+    pixels = calloc(width * height, 1);
+    if (!pixels)
+        return 1;
+
+    // P4: rows of packed bits, MSB first, each row starting at a new byte
+    // P1: one '0' or '1' per pixel, blanks ignored
+    for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+        {
+            if (raw)
+            {
+                if (x % 8 == 0)
+                    c = fgetc(f);
+                bit = (c >> (7 - x % 8)) & 1;
+            }
+            else
+            {
+                do
+                    c = fgetc(f);
+                while (isspace(c));
+                bit = (c == '1');
+            }
+            if (c == EOF)
+            {
+                fprintf(stderr, "%s: image data too short\n", argv[1]);
+                return 1;
+            }
+            pixels[y * width + x] = bit;
+        }
+    fclose(f);
+
+    // Lines of 8 rows, one byte per column, bit 0 on top
+    lines = (height + 7) / 8;
+    printf("// %s: %d x %d pixels, from %s\n", argv[2], width, height, argv[1]);
+    printf("rom unsigned char %s[] = {\n    %d, %d,", argv[2], width, height);
+    for (line = 0; line < lines; line++)
+        for (x = 0; x < width; x++)
+        {
+            n = 0;
+            for (bit = 0; bit < 8 && line * 8 + bit < height; bit++)
+                n |= pixels[(line * 8 + bit) * width + x] << bit;
+            printf("%s0x%02X%s", x % 12 == 0 ? "\n    " : " ", n,
+                   line == lines - 1 && x == width - 1 ? "" : ",");
+        }
+    printf("\n};\n");
+
+    free(pixels);
+    return 0;
+}